@@ -0,0 +1,110 @@
+#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+using namespace unitree::common;
+
+/*
+ * count of heap allocations of process.
+ */
+static std::atomic<uint64_t> gAllocCount(0);
+
+void* operator new(size_t size)
+{
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+
+    void* p = malloc(size ? size : 1);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/*
+ * a config document of some kilobytes, mostly numbers and short strings.
+ */
+std::string MakeDocument()
+{
+    std::string json = "{\"version\":\"1.0.0.1\",\"entries\":[";
+
+    for (int32_t i=0; i<32; i++)
+    {
+        if (i > 0)
+        {
+            json += ",";
+        }
+
+        json += "{\"name\":\"joint_" + std::to_string(i) + "\",\"id\":" + std::to_string(i) +
+            ",\"enabled\":" + (i % 2 == 0 ? "true" : "false") +
+            ",\"gains\":[" + std::to_string(60 + i) + ",1.5,0.01]}";
+    }
+
+    json += "]}";
+    return json;
+}
+
+template<typename F>
+void Measure(const std::string& name, int32_t count, const F& f)
+{
+    uint64_t allocCount = gAllocCount.load();
+    uint64_t startTime = GetCurrentMonotonicTimeNanosecond();
+
+    for (int32_t i=0; i<count; i++)
+    {
+        f();
+    }
+
+    uint64_t time = GetCurrentMonotonicTimeNanosecond() - startTime;
+    allocCount = gAllocCount.load() - allocCount;
+
+    std::cout << "  " << name << ": " << (double)allocCount / count << " allocs, "
+        << (double)time / count << " ns" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    int32_t count = 10000;
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+
+    std::string json = MakeDocument();
+    std::cout << "document: " << json.size() << " bytes, calls: " << count << std::endl;
+
+    JsonMap tree;
+
+    Measure("parse", count, [&]() {
+        JsonMap m;
+        JsonReader reader(json.data(), json.size());
+        reader.Parse(m);
+        tree.swap(m);
+    });
+
+    Measure("copy", count, [&]() {
+        JsonMap m(tree);
+    });
+
+    Measure("scalars", count, [&]() {
+        Any a(1.5);
+        Any b(std::string("joint_1"));
+        Any c(a);
+        c = b;
+    });
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <unitree/robot/channel/channel_publisher.hpp>
+#include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/common/time/sleep.hpp>
+#include <unitree/idl/ros2/String_.hpp>
+#include <iostream>
+#include <cstring>
+
+#define TOPIC_PREFIX "rt/benchmark/startup_"
+#define MATCH_TIMEOUT_MICROSEC 1000000
+
+using namespace unitree::robot;
+using namespace unitree::common;
+using namespace std_msgs::msg::dds_;
+
+/*
+ * Time to set up channelCount publishers with one subscriber each.
+ * --legacy adds the fixed 100ms sleep per writer of previous versions.
+ */
+int main(int argc, const char** argv)
+{
+    int32_t channelCount = 40;
+    bool legacy = false;
+
+    for (int32_t i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--legacy") == 0)
+        {
+            legacy = true;
+        }
+        else
+        {
+            channelCount = atoi(argv[i]);
+        }
+    }
+
+    ChannelFactory::Instance()->Init(0);
+
+    std::vector<ChannelSubscriberPtr<String_>> subscribers;
+    for (int32_t i=0; i<channelCount; i++)
+    {
+        ChannelSubscriberPtr<String_> subscriber(new ChannelSubscriber<String_>(TOPIC_PREFIX + std::to_string(i)));
+        subscriber->InitChannel([](const String_&){});
+        subscribers.push_back(subscriber);
+    }
+
+    uint64_t startTime = GetCurrentMonotonicTimeMicrosecond();
+
+    std::vector<ChannelPublisherPtr<String_>> publishers;
+    for (int32_t i=0; i<channelCount; i++)
+    {
+        ChannelPublisherPtr<String_> publisher(new ChannelPublisher<String_>(TOPIC_PREFIX + std::to_string(i)));
+        publisher->InitChannel();
+
+        if (legacy)
+        {
+            MicroSleep(UT_DDS_WAIT_MATCHED_TIME_MICRO_SEC);
+        }
+
+        publishers.push_back(publisher);
+    }
+
+    uint64_t createTime = GetCurrentMonotonicTimeMicrosecond();
+
+    int32_t matchedCount = 0;
+    for (ChannelPublisherPtr<String_>& publisher : publishers)
+    {
+        if (publisher->WaitForSubscribers(1, MATCH_TIMEOUT_MICROSEC))
+        {
+            matchedCount ++;
+        }
+    }
+
+    uint64_t matchTime = GetCurrentMonotonicTimeMicrosecond();
+
+    std::cout << "channels: " << channelCount << (legacy ? " (legacy sleep)" : "") << std::endl;
+    std::cout << "create publishers: " << (createTime - startTime) / 1000.0 << " ms" << std::endl;
+    std::cout << "wait matched: " << (matchTime - createTime) / 1000.0 << " ms, matched "
+              << matchedCount << "/" << channelCount << std::endl;
+    std::cout << "total startup: " << (matchTime - startTime) / 1000.0 << " ms" << std::endl;
+
+    return 0;
+}
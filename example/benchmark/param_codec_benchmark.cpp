@@ -0,0 +1,140 @@
+#include <unitree/common/codec/binary_codec.hpp>
+#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <iostream>
+
+using namespace unitree::common;
+
+/*
+ * parameter of a velocity api, as Move/SetVelocity.
+ */
+class MoveParameter : public Jsonize
+{
+public:
+    MoveParameter() :
+        vx(0), vy(0), vyaw(0)
+    {}
+
+    void fromJson(JsonMap& json)
+    {
+        FromJson(json["x"], vx);
+        FromJson(json["y"], vy);
+        FromJson(json["z"], vyaw);
+    }
+
+    void toJson(JsonMap& json) const
+    {
+        ToJson(vx, json["x"]);
+        ToJson(vy, json["y"]);
+        ToJson(vyaw, json["z"]);
+    }
+
+    UT_BINARY_CODEC(vx, vy, vyaw)
+
+public:
+    float vx;
+    float vy;
+    float vyaw;
+};
+
+/*
+ * parameter with an array field, as a joint command.
+ */
+class JointParameter : public Jsonize
+{
+public:
+    JointParameter() :
+        mode(0)
+    {}
+
+    void fromJson(JsonMap& json)
+    {
+        FromJson(json["name"], name);
+        FromJson(json["mode"], mode);
+        FromJson(json["q"], q);
+    }
+
+    void toJson(JsonMap& json) const
+    {
+        ToJson(name, json["name"]);
+        ToJson(mode, json["mode"]);
+        ToJson(q, json["q"]);
+    }
+
+    UT_BINARY_CODEC(name, mode, q)
+
+public:
+    std::string name;
+    int32_t mode;
+    std::vector<float> q;
+};
+
+template<typename T>
+void Benchmark(const std::string& name, const T& parameter, int32_t count)
+{
+    std::string json;
+    std::vector<uint8_t> binary;
+    T result;
+
+    uint64_t startTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        json = ToJsonString(parameter);
+    }
+
+    uint64_t jsonEncodeTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        FromJsonString(json, result);
+    }
+
+    uint64_t jsonDecodeTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        EncodeBinary(parameter, binary);
+    }
+
+    uint64_t binaryEncodeTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        DecodeBinary(binary, result);
+    }
+
+    uint64_t binaryDecodeTime = GetCurrentMonotonicTimeNanosecond();
+
+    std::cout << name << std::endl;
+    std::cout << "  json   size: " << json.size() << " bytes, encode: "
+        << (double)(jsonEncodeTime - startTime) / count << " ns, decode: "
+        << (double)(jsonDecodeTime - jsonEncodeTime) / count << " ns" << std::endl;
+    std::cout << "  binary size: " << binary.size() << " bytes, encode: "
+        << (double)(binaryEncodeTime - jsonDecodeTime) / count << " ns, decode: "
+        << (double)(binaryDecodeTime - binaryEncodeTime) / count << " ns" << std::endl;
+}
+
+/*
+ * Encode/decode cost and payload size of json and binary parameter codec.
+ */
+int main(int argc, const char** argv)
+{
+    int32_t count = 100000;
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+
+    MoveParameter move;
+    move.vx = 0.3f;
+    move.vy = -0.1f;
+    move.vyaw = 0.25f;
+
+    JointParameter joint;
+    joint.name = "arm";
+    joint.mode = 1;
+    joint.q.resize(29, 0.125f);
+
+    std::cout << "calls: " << count << std::endl;
+    Benchmark("move", move, count);
+    Benchmark("joint", joint, count);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <unitree/common/dds/dds_easy_model.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/idl/hg/LowState_.hpp>
+#include <iostream>
+
+#define TOPIC "rt/benchmark/topic_handle"
+
+using namespace unitree::common;
+using namespace unitree_hg::msg::dds_;
+
+/*
+ * Write cost of DdsEasyModel by topic name and by DdsTopicHandle.
+ */
+int main(int argc, const char** argv)
+{
+    int32_t count = 1000000;
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+
+    DdsEasyModel model;
+    model.Init(0);
+
+    //some more topics, as a service usually registers
+    for (int32_t i=0; i<16; i++)
+    {
+        model.SetTopic<LowState_>(std::string(TOPIC "_") + std::to_string(i));
+    }
+
+    DdsTopicHandle<LowState_> handle = model.SetTopic<LowState_>(TOPIC);
+
+    LowState_ message;
+
+    uint64_t startTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        message.tick(i);
+        model.WriteMessage<LowState_>(TOPIC, message);
+    }
+
+    uint64_t nameTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        message.tick(i);
+        handle.Write(message);
+    }
+
+    uint64_t handleTime = GetCurrentMonotonicTimeNanosecond();
+
+    std::cout << "writes: " << count << std::endl;
+    std::cout << "by topic name: " << (double)(nameTime - startTime) / count << " ns/write" << std::endl;
+    std::cout << "by topic handle: " << (double)(handleTime - nameTime) / count << " ns/write" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <unitree/robot/channel/channel_publisher.hpp>
+#include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/common/time/sleep.hpp>
+#include <unitree/idl/go2/LowCmd_.hpp>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+
+#define TOPIC_PREFIX "rt/benchmark/write_batch_"
+#define TOPIC_COUNT 4
+#define MATCH_TIMEOUT_MICROSEC 5000000
+#define TICK_MICROSEC 2000
+
+using namespace unitree::robot;
+using namespace unitree::common;
+using namespace unitree_go::msg::dds_;
+
+/*
+ * udp datagrams sent by host, from Udp OutDatagrams of /proc/net/snmp.
+ * Other traffic of host is counted too, run it on a quiet machine.
+ */
+int64_t GetUdpOutDatagrams()
+{
+    std::ifstream file("/proc/net/snmp");
+    std::string header, values;
+
+    while (std::getline(file, header) && std::getline(file, values))
+    {
+        if (header.compare(0, 4, "Udp:") != 0)
+        {
+            continue;
+        }
+
+        std::istringstream names(header), counts(values);
+        std::string name, count;
+
+        while (names >> name && counts >> count)
+        {
+            if (name == "OutDatagrams")
+            {
+                return atoll(count.c_str());
+            }
+        }
+    }
+
+    return -1;
+}
+
+void RunTicks(std::vector<ChannelPublisherPtr<LowCmd_>>& publishers, int32_t tickCount, int32_t writeCount, bool batch)
+{
+    LowCmd_ message;
+
+    for (int32_t tick=0; tick<tickCount; tick++)
+    {
+        auto writeTick = [&]() {
+            for (int32_t i=0; i<writeCount; i++)
+            {
+                message.crc(tick * writeCount + i);
+                for (ChannelPublisherPtr<LowCmd_>& publisher : publishers)
+                {
+                    publisher->Write(message);
+                }
+            }
+        };
+
+        if (batch)
+        {
+            ChannelFactory::Instance()->PublishBatch(writeTick);
+        }
+        else
+        {
+            writeTick();
+        }
+
+        MicroSleep(TICK_MICROSEC);
+    }
+}
+
+/*
+ * Udp datagrams per control tick writing TOPIC_COUNT channels, without and
+ * with PublishBatch. Start "sub" in another process or on another host
+ * first, then "pub [ticks] [writes per channel per tick]". Writers keep
+ * a packet each, so a batch saves packets where a channel is written more
+ * than once per tick.
+ */
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: " << argv[0] << " sub | pub [ticks] [writes]" << std::endl;
+        return 1;
+    }
+
+    ChannelFactory::Instance()->Init(0);
+
+    if (strcmp(argv[1], "sub") == 0)
+    {
+        std::vector<ChannelSubscriberPtr<LowCmd_>> subscribers;
+        for (int32_t i=0; i<TOPIC_COUNT; i++)
+        {
+            ChannelSubscriberPtr<LowCmd_> subscriber(new ChannelSubscriber<LowCmd_>(TOPIC_PREFIX + std::to_string(i)));
+            subscriber->InitChannel([](const LowCmd_&){});
+            subscribers.push_back(subscriber);
+        }
+
+        while (true)
+        {
+            MicroSleep(1000000);
+        }
+    }
+
+    int32_t tickCount = (argc > 2) ? atoi(argv[2]) : 1000;
+    int32_t writeCount = (argc > 3) ? atoi(argv[3]) : 1;
+
+    ChannelFactory::Instance()->EnableWriteBatch();
+
+    std::vector<ChannelPublisherPtr<LowCmd_>> publishers;
+    for (int32_t i=0; i<TOPIC_COUNT; i++)
+    {
+        ChannelPublisherPtr<LowCmd_> publisher(new ChannelPublisher<LowCmd_>(TOPIC_PREFIX + std::to_string(i)));
+        publisher->InitChannel();
+
+        if (!publisher->WaitForSubscribers(1, MATCH_TIMEOUT_MICROSEC))
+        {
+            std::cout << "no subscriber of " << publisher->GetChannelName() << ", start sub first" << std::endl;
+            return 1;
+        }
+
+        publishers.push_back(publisher);
+    }
+
+    int64_t startCount = GetUdpOutDatagrams();
+    RunTicks(publishers, tickCount, writeCount, false);
+
+    int64_t plainCount = GetUdpOutDatagrams();
+    RunTicks(publishers, tickCount, writeCount, true);
+
+    int64_t batchCount = GetUdpOutDatagrams();
+
+    std::cout << "ticks: " << tickCount << ", channels: " << TOPIC_COUNT << ", writes per channel: " << writeCount << std::endl;
+    std::cout << "without batch: " << (double)(plainCount - startCount) / tickCount << " datagrams/tick" << std::endl;
+    std::cout << "with batch: " << (double)(batchCount - plainCount) / tickCount << " datagrams/tick" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <iostream>
+
+using namespace unitree::common;
+
+/*
+ * parameter of a velocity api as Jsonize, as SetVelocity.
+ */
+class VelocityParameter : public Jsonize
+{
+public:
+    VelocityParameter() :
+        vx(0), vy(0), vyaw(0), duration(0)
+    {}
+
+    void fromJson(JsonMap& json)
+    {
+        FromJson(json["vx"], vx);
+        FromJson(json["vy"], vy);
+        FromJson(json["vyaw"], vyaw);
+        FromJson(json["duration"], duration);
+    }
+
+    void toJson(JsonMap& json) const
+    {
+        ToJson(vx, json["vx"]);
+        ToJson(vy, json["vy"]);
+        ToJson(vyaw, json["vyaw"]);
+        ToJson(duration, json["duration"]);
+    }
+
+public:
+    float vx;
+    float vy;
+    float vyaw;
+    float duration;
+};
+
+/*
+ * the same parameter registered by UT_JSONIZE.
+ */
+struct Velocity
+{
+    Velocity() :
+        vx(0), vy(0), vyaw(0), duration(0)
+    {}
+
+    float vx;
+    float vy;
+    float vyaw;
+    float duration;
+};
+
+UT_JSONIZE(Velocity, vx, vy, vyaw, duration)
+
+/*
+ * a document of some kilobytes, as a config content.
+ */
+struct ConfigEntry
+{
+    ConfigEntry() :
+        id(0), enabled(false)
+    {}
+
+    std::string name;
+    int32_t id;
+    bool enabled;
+    std::vector<double> gains;
+};
+
+UT_JSONIZE(ConfigEntry, name, id, enabled, gains)
+
+struct ConfigDocument
+{
+    std::string version;
+    std::vector<ConfigEntry> entries;
+};
+
+UT_JSONIZE(ConfigDocument, version, entries)
+
+template<typename F>
+double Measure(int32_t count, const F& f)
+{
+    uint64_t startTime = GetCurrentMonotonicTimeNanosecond();
+    for (int32_t i=0; i<count; i++)
+    {
+        f();
+    }
+
+    return (double)(GetCurrentMonotonicTimeNanosecond() - startTime) / count;
+}
+
+/*
+ * T by Any tree against T by JsonReader/JsonWriter.
+ */
+template<typename T>
+void Benchmark(const std::string& name, const T& value, int32_t count)
+{
+    std::string json, buffer;
+    T result;
+
+    double anyWrite = Measure(count, [&]() {
+        Any a;
+        ToJson(value, a);
+        json = ToJsonString(a);
+    });
+
+    double anyRead = Measure(count, [&]() {
+        T t;
+        FromJson(FromJsonString(json), t);
+    });
+
+    double directWrite = Measure(count, [&]() {
+        ToJsonString(value, buffer);
+    });
+
+    double directRead = Measure(count, [&]() {
+        T t;
+        FromJsonString(buffer, t);
+    });
+
+    std::cout << name << ": " << buffer.size() << " bytes" << std::endl;
+    std::cout << "  any tree write: " << anyWrite << " ns, read: " << anyRead << " ns" << std::endl;
+    std::cout << "  direct   write: " << directWrite << " ns, read: " << directRead << " ns" << std::endl;
+}
+
+/*
+ * JsonMap built by hand, as clients filling a map parameter: lib writer of
+ * Any against JsonWriter. Read is by Any tree either way.
+ */
+void BenchmarkJsonMap(const std::string& name, const JsonMap& value, int32_t count)
+{
+    std::string json, buffer;
+
+    double anyWrite = Measure(count, [&]() {
+        json = ToJsonString(Any(value));
+    });
+
+    double directWrite = Measure(count, [&]() {
+        ToJsonString(value, buffer);
+    });
+
+    std::cout << name << ": " << buffer.size() << " bytes" << std::endl;
+    std::cout << "  any tree write: " << anyWrite << " ns" << std::endl;
+    std::cout << "  direct   write: " << directWrite << " ns" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    int32_t count = 100000;
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+
+    VelocityParameter parameter;
+    parameter.vx = 0.3f;
+    parameter.vy = -0.1f;
+    parameter.vyaw = 0.25f;
+    parameter.duration = 1.0f;
+
+    Velocity velocity;
+    velocity.vx = 0.3f;
+    velocity.vy = -0.1f;
+    velocity.vyaw = 0.25f;
+    velocity.duration = 1.0f;
+
+    ConfigDocument document;
+    document.version = "1.0.0.1";
+    for (int32_t i=0; i<32; i++)
+    {
+        ConfigEntry entry;
+        entry.name = "joint_" + std::to_string(i);
+        entry.id = i;
+        entry.enabled = (i % 2 == 0);
+        entry.gains = {60.0 + i, 1.5, 0.01 * i};
+        document.entries.push_back(entry);
+    }
+
+    JsonMap volume;
+    volume["name"] = Any(std::string("volume"));
+    volume["value"] = Any(int32_t(80));
+    volume["gains"] = Any(JsonArray{Any(60.0), Any(1.5), Any(0.01)});
+
+    std::cout << "calls: " << count << std::endl;
+
+    /*
+     * a Jsonize class is written from its toJson map, read by Any tree.
+     */
+    Benchmark("velocity (Jsonize)", parameter, count);
+    Benchmark("velocity (UT_JSONIZE)", velocity, count);
+    Benchmark("config (UT_JSONIZE)", document, count / 10 + 1);
+    BenchmarkJsonMap("volume (JsonMap)", volume, count);
+
+    return 0;
+}
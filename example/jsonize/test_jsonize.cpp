@@ -29,6 +29,22 @@ public:
     int y;
     int z;
 };
+
+/*
+ * Fields registered by UT_JSONIZE are parsed without a tree of Any.
+ */
+struct Point
+{
+    Point() : x(0), y(0), z(0)
+    {}
+
+    int x;
+    int y;
+    int z;
+    std::string name;
+};
+
+UT_JSONIZE(Point, x, y, z, name)
 }
 }
 
@@ -82,5 +98,16 @@ int main()
 
     std::cout << s << std::endl;
 
+    std::vector<Point> points;
+    FromJsonString("[{\"x\":1,\"y\":2,\"z\":3,\"name\":\"p1\"},{\"x\":4,\"name\":\"p2\"}]", points);
+
+    for (i=0; i<points.size(); i++)
+    {
+        const Point& p = points[i];
+        std::cout << p.name << ": x=" << p.x << ", y=" << p.y << ", z=" << p.z << std::endl;
+    }
+
+    std::cout << ToJsonString(points) << std::endl;
+
     return 0;
 }
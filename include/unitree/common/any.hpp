@@ -14,9 +14,10 @@ public:
         : mContent(0)
     {}
 
-    template<typename ValueType>
-    Any(const ValueType& value)
-        : mContent(new Holder<ValueType>(value))
+    template<typename ValueType, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<ValueType>::type, Any>::value>::type>
+    Any(ValueType&& value)
+        : mContent(new Holder<typename std::decay<ValueType>::type>(std::forward<ValueType>(value)))
     {}
 
     Any(const char* s)
@@ -31,10 +32,15 @@ public:
         : mContent(other.mContent ? other.mContent->Clone() : 0)
     {}
 
+    Any(Any&& other) noexcept
+        : mContent(0)
+    {
+        MoveFrom(other);
+    }
+
     ~Any()
     {
-        delete mContent;
-        mContent = 0;
+        Destroy();
     }
 
     Any& Swap(Any& other)
@@ -53,16 +59,32 @@ public:
         return mContent ? mContent->GetTypeInfo() : typeid(void);
     }
 
-    template<typename ValueType>
-    Any& operator=(const ValueType& other)
+    template<typename ValueType, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<ValueType>::type, Any>::value>::type>
+    Any& operator=(ValueType&& other)
     {
-        Any(other).Swap(*this);
+        Any(std::forward<ValueType>(other)).Swap(*this);
+        return *this;
+    }
+
+    Any& operator=(const Any& other)
+    {
+        if (this != &other)
+        {
+            Any(other).Swap(*this);
+        }
+
         return *this;
     }
 
-    Any& operator=(Any other)
+    Any& operator=(Any&& other) noexcept
     {
-        other.Swap(*this);
+        if (this != &other)
+        {
+            Destroy();
+            MoveFrom(other);
+        }
+
         return *this;
     }
 
@@ -86,6 +108,10 @@ public:
             : mValue(value)
         {}
 
+        explicit Holder(ValueType&& value)
+            : mValue(std::move(value))
+        {}
+
         virtual const std::type_info& GetTypeInfo() const
         {
             return typeid(ValueType);
@@ -100,6 +126,22 @@ public:
         ValueType mValue;
     };
 
+private:
+    /*
+     * Take content of other, which is left empty.
+     */
+    void MoveFrom(Any& other) noexcept
+    {
+        mContent = other.mContent;
+        other.mContent = 0;
+    }
+
+    void Destroy()
+    {
+        delete mContent;
+        mContent = 0;
+    }
+
 public:
     PlaceHolder* mContent;
 };
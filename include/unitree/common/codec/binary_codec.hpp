@@ -0,0 +1,281 @@
+#ifndef __UT_BINARY_CODEC_HPP__
+#define __UT_BINARY_CODEC_HPP__
+
+#include <array>
+#include <unitree/common/decl.hpp>
+
+/*
+ * version byte leading every encoded buffer.
+ */
+#define UT_BINARY_CODEC_VERSION     1
+
+/*
+ * Declare Encode/Decode of a class from its field list, fields are packed
+ * in the listed order:
+ *
+ * class MoveParameter : public common::Jsonize
+ * {
+ * public:
+ *     ...
+ *     UT_BINARY_CODEC(vx, vy, vyaw)
+ * };
+ */
+#define UT_BINARY_CODEC(...)                                            \
+    void Encode(unitree::common::BinaryEncoder& encoder) const          \
+    {                                                                   \
+        encoder.Put(__VA_ARGS__);                                       \
+    }                                                                   \
+    bool Decode(unitree::common::BinaryDecoder& decoder)                \
+    {                                                                   \
+        return decoder.Get(__VA_ARGS__);                                \
+    }
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "binary codec supports little endian only");
+
+namespace unitree
+{
+namespace common
+{
+class BinaryEncoder;
+class BinaryDecoder;
+
+template<typename T, typename = void>
+struct IsBinaryCodec : std::false_type
+{};
+
+template<typename T>
+struct IsBinaryCodec<T, decltype(std::declval<const T&>().Encode(std::declval<BinaryEncoder&>()))> : std::true_type
+{};
+
+/*
+ * @brief: BinaryEncoder
+ *         Packs fields into buffer: arithmetic and enum values in host
+ *         (little endian) layout, string and vector as uint32 length and
+ *         elements, array as elements, nested class by its Encode.
+ */
+class BinaryEncoder
+{
+public:
+    explicit BinaryEncoder(std::vector<uint8_t>& buffer) :
+        mBuffer(buffer)
+    {}
+
+    void Put()
+    {}
+
+    template<typename T, typename... Ts>
+    void Put(const T& value, const Ts&... values)
+    {
+        PutValue(value);
+        Put(values...);
+    }
+
+private:
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type PutValue(const T& value)
+    {
+        PutBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    typename std::enable_if<IsBinaryCodec<T>::value>::type PutValue(const T& value)
+    {
+        value.Encode(*this);
+    }
+
+    void PutValue(const std::string& value)
+    {
+        PutValue((uint32_t)value.size());
+        PutBytes(value.data(), value.size());
+    }
+
+    template<typename T>
+    void PutValue(const std::vector<T>& value)
+    {
+        PutValue((uint32_t)value.size());
+        PutElements(value.data(), value.size());
+    }
+
+    template<typename T, size_t N>
+    void PutValue(const std::array<T,N>& value)
+    {
+        PutElements(value.data(), N);
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type PutElements(const T* values, size_t count)
+    {
+        PutBytes(values, sizeof(T) * count);
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value>::type PutElements(const T* values, size_t count)
+    {
+        for (size_t i=0; i<count; i++)
+        {
+            PutValue(values[i]);
+        }
+    }
+
+    void PutBytes(const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        mBuffer.insert(mBuffer.end(), p, p + size);
+    }
+
+private:
+    std::vector<uint8_t>& mBuffer;
+};
+
+/*
+ * @brief: BinaryDecoder
+ *         Reverse of BinaryEncoder. Get returns false if buffer is short,
+ *         bytes left after the last field are ignored, so fields appended by
+ *         a newer peer do not break an older one.
+ */
+class BinaryDecoder
+{
+public:
+    explicit BinaryDecoder(const uint8_t* data, size_t size) :
+        mData(data), mSize(size), mPos(0)
+    {}
+
+    bool Get()
+    {
+        return true;
+    }
+
+    template<typename T, typename... Ts>
+    bool Get(T& value, Ts&... values)
+    {
+        return GetValue(value) && Get(values...);
+    }
+
+    size_t GetPosition() const
+    {
+        return mPos;
+    }
+
+private:
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, bool>::type GetValue(T& value)
+    {
+        return GetBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    typename std::enable_if<IsBinaryCodec<T>::value, bool>::type GetValue(T& value)
+    {
+        return value.Decode(*this);
+    }
+
+    bool GetValue(std::string& value)
+    {
+        uint32_t size = 0;
+        if (!GetValue(size) || mSize - mPos < size)
+        {
+            return false;
+        }
+
+        value.assign((const char*)mData + mPos, size);
+        mPos += size;
+
+        return true;
+    }
+
+    template<typename T>
+    bool GetValue(std::vector<T>& value)
+    {
+        /*
+         * every element takes at least one byte, a count beyond the data
+         * left is rejected before anything is allocated.
+         */
+        const size_t elementSize = std::is_arithmetic<T>::value ? sizeof(T) : 1;
+
+        uint32_t count = 0;
+        if (!GetValue(count) || (mSize - mPos) / elementSize < (size_t)count)
+        {
+            return false;
+        }
+
+        value.resize(count);
+        return GetElements(value.data(), count);
+    }
+
+    template<typename T, size_t N>
+    bool GetValue(std::array<T,N>& value)
+    {
+        return GetElements(value.data(), N);
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, bool>::type GetElements(T* values, size_t count)
+    {
+        return GetBytes(values, sizeof(T) * count);
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type GetElements(T* values, size_t count)
+    {
+        for (size_t i=0; i<count; i++)
+        {
+            if (!GetValue(values[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool GetBytes(void* data, size_t size)
+    {
+        if (mSize - mPos < size)
+        {
+            return false;
+        }
+
+        memcpy(data, mData + mPos, size);
+        mPos += size;
+
+        return true;
+    }
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mPos;
+};
+
+/*
+ * Encode t into buffer, buffer is cleared first.
+ */
+template<typename T>
+void EncodeBinary(const T& t, std::vector<uint8_t>& buffer)
+{
+    buffer.clear();
+    buffer.push_back(UT_BINARY_CODEC_VERSION);
+
+    BinaryEncoder encoder(buffer);
+    t.Encode(encoder);
+}
+
+/*
+ * Decode t from buffer, false if version or data mismatch.
+ */
+template<typename T>
+bool DecodeBinary(const std::vector<uint8_t>& buffer, T& t)
+{
+    if (buffer.empty() || buffer[0] != UT_BINARY_CODEC_VERSION)
+    {
+        return false;
+    }
+
+    BinaryDecoder decoder(buffer.data() + 1, buffer.size() - 1);
+    return t.Decode(decoder);
+}
+
+}
+}
+
+#endif//__UT_BINARY_CODEC_HPP__
@@ -22,8 +22,11 @@ public:
     void Init(const std::string& ddsParameterFileName = "");
     void Init(const JsonMap& param);
 
+    /*
+     * Register topic writer, the handle writes without topic lookup.
+     */
     template<typename MSG>
-    void SetTopic(const std::string& topic)
+    DdsTopicHandle<MSG> SetTopic(const std::string& topic)
     {
         DdsTopicChannelPtr<MSG> channel = GetChannel<MSG>(topic);
         if (!channel)
@@ -47,17 +50,19 @@ public:
         {
             UT_THROW(CommonException, std::string("topic reader is already exist. topic:") + topic);
         }
+
+        return DdsTopicHandle<MSG>(channel);
     }
 
     template<typename MSG>
-    void SetTopic(const std::string& topic, const DdsMessageHandler& handler, int32_t queuelen = 0)
+    DdsTopicHandle<MSG> SetTopic(const std::string& topic, const DdsMessageHandler& handler, int32_t queuelen = 0)
     {
         DdsReaderCallback cb(handler);
-        SetTopic<MSG>(topic, cb, queuelen);
+        return SetTopic<MSG>(topic, cb, queuelen);
     }
 
     template<typename MSG>
-    void SetTopic(const std::string& topic, const DdsReaderCallback& rcb, int32_t queuelen = 0)
+    DdsTopicHandle<MSG> SetTopic(const std::string& topic, const DdsReaderCallback& rcb, int32_t queuelen = 0)
     {
         DdsTopicChannelPtr<MSG> channel = GetChannel<MSG>(topic);
         if (!channel)
@@ -81,10 +86,12 @@ public:
         {
             UT_THROW(CommonException, std::string("topic reader is already exist. topic:") + topic);
         }
+
+        return DdsTopicHandle<MSG>(channel);
     }
 
     template<typename MSG>
-    bool WriteMessage(const std::string topic, const MSG& message, int64_t waitMicrosec = 0)
+    bool WriteMessage(const std::string& topic, const MSG& message, int64_t waitMicrosec = 0)
     {
         DdsTopicChannelPtr<MSG> channel = GetChannel<MSG>(topic);
         if (channel == NULL)
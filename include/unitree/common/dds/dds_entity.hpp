@@ -4,6 +4,7 @@
 #include <dds/dds.hpp>
 #include <unitree/common/log/log.hpp>
 #include <unitree/common/block_queue.hpp>
+#include <unitree/common/ring_queue.hpp>
 #include <unitree/common/thread/thread.hpp>
 #include <unitree/common/time/time_tool.hpp>
 #include <unitree/common/time/sleep.hpp>
@@ -11,11 +12,12 @@
 #include <unitree/common/dds/dds_callback.hpp>
 #include <unitree/common/dds/dds_qos.hpp>
 #include <unitree/common/dds/dds_traits.hpp>
+#include <unitree/common/dds/dds_executor.hpp>
 
 #define __UT_DDS_NULL__ ::dds::core::null
 
 /*
- * dds wait sub/pub matched default time slice.
+ * shortest wait of a write for a matched reader, and longest one.
  * default 10000 us
  */
 #define __UT_DDS_WAIT_MATCHED_TIME_SLICE 10000
@@ -137,6 +139,204 @@ template<typename MSG>
 using DdsTopicPtr = std::shared_ptr<DdsTopic<MSG>>;
 
 
+/*
+ * @brief: DdsWriteBatch
+ *         Scoped write batch of calling thread. Batch capable writers are
+ *         created with dds write batching, their writes stay in the writer
+ *         until flushed. Writers written in the scope are flushed once each
+ *         when it ends, nested batches are flushed by the outermost one.
+ */
+#define UT_DDS_WRITE_BATCH_WRITER_MAX 32
+
+class DdsWriteBatch
+{
+public:
+    explicit DdsWriteBatch() :
+        mWriterCount(0), mPrevious(Current())
+    {
+        Current() = this;
+    }
+
+    ~DdsWriteBatch()
+    {
+        Current() = mPrevious;
+
+        if (mPrevious != NULL)
+        {
+            for (uint32_t i=0; i<mWriterCount; i++)
+            {
+                mPrevious->Add(mWriters[i]);
+            }
+        }
+        else
+        {
+            Flush();
+        }
+    }
+
+    static DdsWriteBatch*& Current()
+    {
+        static thread_local DdsWriteBatch* current = NULL;
+        return current;
+    }
+
+    void Add(dds_entity_t writer)
+    {
+        for (uint32_t i=0; i<mWriterCount; i++)
+        {
+            if (mWriters[i] == writer)
+            {
+                return;
+            }
+        }
+
+        if (mWriterCount == UT_DDS_WRITE_BATCH_WRITER_MAX)
+        {
+            Flush();
+        }
+
+        mWriters[mWriterCount++] = writer;
+    }
+
+    void Flush()
+    {
+        for (uint32_t i=0; i<mWriterCount; i++)
+        {
+            dds_write_flush(mWriters[i]);
+        }
+
+        mWriterCount = 0;
+    }
+
+    /*
+     * dds write batching is a switch of the domain read when a writer is
+     * created, it is on only while a batch capable writer is created.
+     */
+    static Mutex& GetCreateMutex()
+    {
+        static Mutex mutex;
+        return mutex;
+    }
+
+private:
+    uint32_t mWriterCount;
+    dds_entity_t mWriters[UT_DDS_WRITE_BATCH_WRITER_MAX];
+    DdsWriteBatch* mPrevious;
+};
+
+/*
+ * Count of readers matched with writer. It does not take publication
+ * matched status.
+ */
+inline int32_t DdsGetMatchedCount(dds_entity_t writer)
+{
+    dds_return_t count = dds_get_matched_subscriptions(writer, NULL, 0);
+    return count < 0 ? 0 : (int32_t)count;
+}
+
+/*
+ * @brief: DdsWriterMatchedStatus
+ *         Publication matched status of a writer told by its listener.
+ *         The status is not taken, so waiters are woken by every match
+ *         and do not take it from each other.
+ */
+class DdsWriterMatchedStatus
+{
+public:
+    explicit DdsWriterMatchedStatus() :
+        mWriter(0), mGeneration(0)
+    {}
+
+    ~DdsWriterMatchedStatus()
+    {
+        Detach();
+    }
+
+    void Attach(dds_entity_t writer)
+    {
+        mWriter = writer;
+
+        dds_listener_t* listener = dds_create_listener(this);
+        dds_lset_publication_matched_arg(listener, &DdsWriterMatchedStatus::OnPublicationMatched, this, false);
+        dds_set_listener(mWriter, listener);
+        dds_delete_listener(listener);
+    }
+
+    /*
+     * Must be called before writer is deleted, waits for listener calls running.
+     */
+    void Detach()
+    {
+        if (mWriter > 0)
+        {
+            dds_set_listener(mWriter, NULL);
+            mWriter = 0;
+        }
+    }
+
+    /*
+     * Moves whenever a reader is matched or unmatched.
+     */
+    uint32_t GetGeneration() const
+    {
+        return mGeneration.load(std::memory_order_acquire);
+    }
+
+    int32_t GetMatchedCount() const
+    {
+        return DdsGetMatchedCount(mWriter);
+    }
+
+    /*
+     * Wait until count readers are matched, for at most waitMicrosec.
+     */
+    bool Wait(int32_t count, int64_t waitMicrosec)
+    {
+        if (GetMatchedCount() >= count)
+        {
+            return true;
+        }
+
+        if (waitMicrosec <= 0)
+        {
+            return false;
+        }
+
+        uint64_t deadline = GetCurrentMonotonicTimeMicrosecond() + waitMicrosec;
+
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        //listener notifies under lock, a match after count checked wakes the wait
+        while (GetMatchedCount() < count)
+        {
+            uint64_t now = GetCurrentMonotonicTimeMicrosecond();
+            if (now >= deadline)
+            {
+                return false;
+            }
+
+            mMutexCond.Wait(deadline - now);
+        }
+
+        return true;
+    }
+
+private:
+    static void OnPublicationMatched(dds_entity_t, const dds_publication_matched_status_t, void* arg)
+    {
+        DdsWriterMatchedStatus* self = (DdsWriterMatchedStatus*)arg;
+        self->mGeneration.fetch_add(1, std::memory_order_release);
+
+        LockGuard<MutexCond> guard(self->mMutexCond);
+        self->mMutexCond.NotifyAll();
+    }
+
+private:
+    dds_entity_t mWriter;
+    std::atomic<uint32_t> mGeneration;
+    MutexCond mMutexCond;
+};
+
 /*
  * @brief: DdsWriter
  */
@@ -146,21 +346,49 @@ class DdsWriter : public DdsLogger
 public:
     using NATIVE_TYPE = ::dds::pub::DataWriter<MSG>;
 
-    explicit DdsWriter(const DdsPublisherPtr publisher, const DdsTopicPtr<MSG>& topic, const DdsWriterQos& qos) :
-        mNative(__UT_DDS_NULL__)
+    /*
+     * batch: writes within a DdsWriteBatch are held by this writer and
+     * sent when the batch ends, writes without one are sent at once.
+     */
+    explicit DdsWriter(const DdsPublisherPtr publisher, const DdsTopicPtr<MSG>& topic, const DdsWriterQos& qos, bool batch = false) :
+        mNative(__UT_DDS_NULL__), mBatch(batch)
     {
         UT_DDS_EXCEPTION_TRY
 
         auto writerQos = publisher->GetNative().default_datawriter_qos();
         qos.CopyToNativeQos(writerQos);
 
-        mNative = NATIVE_TYPE(publisher->GetNative(), topic->GetNative(), writerQos);
+        if (batch)
+        {
+            LockGuard<Mutex> guard(DdsWriteBatch::GetCreateMutex());
+
+            dds_write_set_batch(true);
+
+            try
+            {
+                mNative = NATIVE_TYPE(publisher->GetNative(), topic->GetNative(), writerQos);
+            }
+            catch (...)
+            {
+                dds_write_set_batch(false);
+                throw;
+            }
+
+            dds_write_set_batch(false);
+        }
+        else
+        {
+            mNative = NATIVE_TYPE(publisher->GetNative(), topic->GetNative(), writerQos);
+        }
+
+        mMatchedStatus.Attach(mNative->get_ddsc_entity());
 
         UT_DDS_EXCEPTION_CATCH(mLogger, true)
     }
 
     ~DdsWriter()
     {
+        mMatchedStatus.Detach();
         mNative = __UT_DDS_NULL__;
     }
 
@@ -179,6 +407,20 @@ public:
         UT_DDS_EXCEPTION_TRY
         {
             mNative.write(message);
+
+            if (mBatch)
+            {
+                DdsWriteBatch* batch = DdsWriteBatch::Current();
+                if (batch != NULL)
+                {
+                    batch->Add(mNative->get_ddsc_entity());
+                }
+                else
+                {
+                    dds_write_flush(mNative->get_ddsc_entity());
+                }
+            }
+
             return true;
         }
         UT_DDS_EXCEPTION_CATCH(mLogger, false)
@@ -186,6 +428,76 @@ public:
         return false;
     }
 
+    /*
+     * Count of matched readers, see DdsGetMatchedCount.
+     */
+    int32_t GetMatchedCount() const
+    {
+        return mMatchedStatus.GetMatchedCount();
+    }
+
+    /*
+     * Instance handles of matched readers.
+     */
+    bool GetMatchedReaders(std::vector<dds_instance_handle_t>& handles)
+    {
+        dds_entity_t entity = mNative->get_ddsc_entity();
+        handles.resize(handles.capacity());
+
+        while (true)
+        {
+            dds_return_t count = dds_get_matched_subscriptions(entity, handles.data(), handles.size());
+            if (count < 0)
+            {
+                handles.clear();
+                return false;
+            }
+
+            bool complete = (size_t)count <= handles.size();
+            handles.resize(count);
+
+            if (complete)
+            {
+                return true;
+            }
+        }
+    }
+
+    bool GetMatchedReaderGuid(dds_instance_handle_t handle, dds_guid_t& guid)
+    {
+        dds_builtintopic_endpoint_t* endpoint = dds_get_matched_subscription_data(mNative->get_ddsc_entity(), handle);
+        if (endpoint == NULL)
+        {
+            return false;
+        }
+
+        memcpy(&guid, &endpoint->key, sizeof(dds_guid_t));
+        dds_builtintopic_free_endpoint(endpoint);
+
+        return true;
+    }
+
+    bool GetGuid(dds_guid_t& guid)
+    {
+        return dds_get_guid(mNative->get_ddsc_entity(), &guid) == DDS_RETCODE_OK;
+    }
+
+    /*
+     * Moves whenever a reader is matched or unmatched.
+     */
+    uint32_t GetMatchedGeneration() const
+    {
+        return mMatchedStatus.GetGeneration();
+    }
+
+    /*
+     * Wait until count readers are matched, see DdsWriterMatchedStatus.
+     */
+    bool WaitMatched(int32_t count, int64_t waitMicrosec)
+    {
+        return mMatchedStatus.Wait(count, waitMicrosec);
+    }
+
 private:
     void WaitReader(int64_t waitMicrosec)
     {
@@ -200,21 +512,73 @@ private:
             waitTime = __UT_DDS_WAIT_MATCHED_TIME_MAX;
         }
 
-        while (waitTime > 0 && mNative.publication_matched_status().current_count() == 0)
-        {
-            MicroSleep(__UT_DDS_WAIT_MATCHED_TIME_SLICE);
-            waitTime -=__UT_DDS_WAIT_MATCHED_TIME_SLICE;
-        }
+        WaitMatched(1, waitTime);
     }
 
 private:
     NATIVE_TYPE mNative;
+    bool mBatch;
+    DdsWriterMatchedStatus mMatchedStatus;
 };
 
 template<typename MSG>
 using DdsWriterPtr = std::shared_ptr<DdsWriter<MSG>>;
 
 
+/*
+ * @brief: DdsLoanedMessage
+ *         Reference-counted handle of one sample in a reader loan. The loan
+ *         is returned to the reader when the last handle is released.
+ */
+template<typename MSG>
+class DdsLoanedMessage
+{
+public:
+    explicit DdsLoanedMessage() :
+        mIndex(0)
+    {}
+
+    explicit DdsLoanedMessage(const ::dds::sub::LoanedSamples<MSG>& samples, uint32_t index) :
+        mSamples(samples), mIndex(index)
+    {}
+
+    bool Valid() const
+    {
+        return mIndex < mSamples.length();
+    }
+
+    const MSG& GetMessage() const
+    {
+        return (mSamples.begin() + mIndex)->data();
+    }
+
+    const ::dds::sub::SampleInfo& GetInfo() const
+    {
+        return (mSamples.begin() + mIndex)->info();
+    }
+
+    const MSG& operator*() const
+    {
+        return GetMessage();
+    }
+
+    const MSG* operator->() const
+    {
+        return &GetMessage();
+    }
+
+private:
+    ::dds::sub::LoanedSamples<MSG> mSamples;
+    uint32_t mIndex;
+};
+
+template<typename MSG>
+using DdsTypedMessageHandler = std::function<void(const MSG&)>;
+
+template<typename MSG>
+using DdsLoanedMessageHandler = std::function<void(const DdsLoanedMessage<MSG>&)>;
+
+
 /*
  * @brief: DdsReaderListener
  */
@@ -226,12 +590,17 @@ public:
     using MSG_PTR = std::shared_ptr<MSG>;
 
     explicit DdsReaderListener() :
-        mHasQueue(false), mQuit(false), mMask(::dds::core::status::StatusMask::none()), mLastDataAvailableTime(0)
+        mHasQueue(false), mQuit(false), mMask(::dds::core::status::StatusMask::none()), mLastDataAvailableTime(0),
+        mDeliveryThread(0), mPublicationUnmatched(false)
     {}
 
     ~DdsReaderListener()
     {
-        if (mHasQueue)
+        if (mExecutorSourcePtr)
+        {
+            mExecutorSourcePtr->Close();
+        }
+        else if (mHasQueue)
         {
             mQuit = true;
             mDataQueuePtr->Interrupt(false);
@@ -249,20 +618,124 @@ public:
         mCallbackPtr.reset(new DdsReaderCallback(cb));
     }
 
+    /*
+     * Typed handler, called with a reference into the reader loan.
+     * The reference is valid only during the call.
+     */
+    void SetTypedHandler(const DdsTypedMessageHandler<MSG>& handler)
+    {
+        if (handler)
+        {
+            mMask |= ::dds::core::status::StatusMask::data_available();
+        }
+
+        mTypedHandler = handler;
+    }
+
+    /*
+     * Loaned handler, called with a handle that keeps the loan alive
+     * after the call returns. Always called on the receive thread.
+     */
+    void SetLoanedHandler(const DdsLoanedMessageHandler<MSG>& handler)
+    {
+        if (handler)
+        {
+            mMask |= ::dds::core::status::StatusMask::data_available();
+        }
+
+        mLoanedHandler = handler;
+    }
+
+    /*
+     * Samples of publication accepted by filter are dropped, they are
+     * delivered by another transport.
+     */
+    void SetPublicationFilter(const std::function<bool(const dds_guid_t&)>& filter)
+    {
+        if (filter)
+        {
+            mMask |= ::dds::core::status::StatusMask::subscription_matched();
+        }
+
+        mPublicationFilter = filter;
+    }
+
+    /*
+     * Deliver message received by another transport.
+     */
+    void Deliver(const MSG& m)
+    {
+        mLastDataAvailableTime.store(GetCurrentMonotonicTimeNanosecond(), std::memory_order_relaxed);
+
+        if (mHasQueue)
+        {
+            Enqueue(m);
+        }
+        else
+        {
+            SerializeDelivery([this, &m]() {
+                OnMessage(m);
+            });
+        }
+    }
+
+    bool HasHandler() const
+    {
+        return mTypedHandler || mLoanedHandler || (mCallbackPtr && mCallbackPtr->HasMessageHandler());
+    }
+
+    /*
+     * Executor class dispatching the queue, must be set before queue.
+     */
+    void SetExecutorClass(const std::string& name)
+    {
+        mExecutorClass = name;
+    }
+
     void SetQueue(int32_t len)
     {
+        DdsExecutorClassPtr executorClassPtr;
+
+        if (mExecutorClass.empty())
+        {
+            executorClassPtr = DdsExecutor::Instance()->GetClass(UT_DDS_EXECUTOR_DEFAULT_CLASS);
+        }
+        else
+        {
+            executorClassPtr = DdsExecutor::Instance()->GetClass(mExecutorClass);
+            if (!executorClassPtr)
+            {
+                UT_THROW(CommonException, std::string("executor class not found: ") + mExecutorClass);
+            }
+
+            if (len <= 0)
+            {
+                len = UT_DDS_EXECUTOR_QUEUE_LEN;
+            }
+        }
+
         if (len <= 0)
         {
             return;
         }
 
         mHasQueue = true;
-        mDataQueuePtr.reset(new BlockQueue<MSG_PTR>(len));
+        mDataQueuePtr.reset(new RingQueue<MSG>(len));
+
+        if (executorClassPtr)
+        {
+            mExecutorClassPtr = executorClassPtr;
+            mExecutorSourcePtr.reset(new DdsReaderExecutorSource(mDataQueuePtr, [this](const MSG& m) {
+                OnMessage(m);
+            }));
+
+            return;
+        }
 
         auto queueThreadFunc = [this]() {
             while (true)
             {
-                if (mCallbackPtr && mCallbackPtr->HasMessageHandler())
+                if (HasHandler())
                 {
                     break;
                 }
@@ -271,15 +744,12 @@ public:
                     MicroSleep(__UT_DDS_WAIT_MATCHED_TIME_SLICE);
                 }
             }
+            MSG_PTR dataPtr(new MSG());
             while (!mQuit)
             {
-                MSG_PTR dataPtr;
-                if (mDataQueuePtr->Get(dataPtr))
+                if (mDataQueuePtr->Get(*dataPtr))
                 {
-                    if (dataPtr)
-                    {
-                        mCallbackPtr->OnDataAvailable(dataPtr.get());
-                    }
+                    OnMessage(*dataPtr);
                 }
             }
             return 0;
@@ -290,7 +760,15 @@ public:
 
     int64_t GetLastDataAvailableTime() const
     {
-        return mLastDataAvailableTime;
+        return mLastDataAvailableTime.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Count of earliest messages evicted from a full queue.
+     */
+    uint64_t GetEvictedCount() const
+    {
+        return mHasQueue ? mDataQueuePtr->GetEvictedCount() : 0;
     }
 
     NATIVE_TYPE* GetNative() const
@@ -304,6 +782,155 @@ public:
     }
 
 private:
+    /*
+     * @brief: DdsReaderExecutorSource
+     */
+    class DdsReaderExecutorSource : public DdsExecutorSource
+    {
+    public:
+        explicit DdsReaderExecutorSource(const RingQueuePtr<MSG>& queuePtr, const std::function<void(const MSG&)>& handler) :
+            mQueuePtr(queuePtr), mHandler(handler), mDataPtr(new MSG())
+        {}
+
+    protected:
+        void DispatchPending(uint32_t max)
+        {
+            for (uint32_t i=0; i<max && mQueuePtr->TryGet(*mDataPtr); i++)
+            {
+                mHandler(*mDataPtr);
+            }
+        }
+
+        bool HasPendingMessage()
+        {
+            return !mQueuePtr->Empty();
+        }
+
+    private:
+        RingQueuePtr<MSG> mQueuePtr;
+        std::function<void(const MSG&)> mHandler;
+        MSG_PTR mDataPtr;
+    };
+
+    void Enqueue(const MSG& m)
+    {
+        mDataQueuePtr->Put(m);
+
+        if (mExecutorSourcePtr)
+        {
+            mExecutorClassPtr->Schedule(mExecutorSourcePtr);
+        }
+    }
+
+    /*
+     * Handlers without queue are called by dds listener, shm reader and
+     * intra-process writing threads, one call at a time. A handler writing
+     * its own topic is called again within its call, as by dds listener.
+     */
+    template<typename F>
+    void SerializeDelivery(const F& func)
+    {
+        //only this thread stores its own id, 0 is no thread
+        pthread_t self = pthread_self();
+        if (mDeliveryThread.load(std::memory_order_relaxed) == self)
+        {
+            func();
+            return;
+        }
+
+        LockGuard<Mutex> guard(mDeliveryMutex);
+
+        mDeliveryThread.store(self, std::memory_order_relaxed);
+        func();
+        mDeliveryThread.store(0, std::memory_order_relaxed);
+    }
+
+    void OnMessage(const MSG& m)
+    {
+        if (mTypedHandler)
+        {
+            mTypedHandler(m);
+        }
+        else if (mCallbackPtr)
+        {
+            mCallbackPtr->OnDataAvailable((const void*)&m);
+        }
+    }
+
+    bool IsPublicationFiltered(::dds::sub::DataReader<MSG>& reader, const ::dds::core::InstanceHandle& handle)
+    {
+        if (mPublicationUnmatched.exchange(false))
+        {
+            DropUnmatchedPublication(reader);
+        }
+
+        dds_instance_handle_t ih = handle->handle();
+
+        auto iter = mPublicationFilterCache.find(ih);
+        if (iter != mPublicationFilterCache.end())
+        {
+            return iter->second;
+        }
+
+        dds_builtintopic_endpoint_t* endpoint = dds_get_matched_publication_data(reader->get_ddsc_entity(), ih);
+        if (endpoint == NULL)
+        {
+            return false;
+        }
+
+        bool filtered = mPublicationFilter(endpoint->key);
+        dds_builtintopic_free_endpoint(endpoint);
+
+        mPublicationFilterCache[ih] = filtered;
+
+        return filtered;
+    }
+
+    /*
+     * Verdicts of publications no longer matched are dropped, the cache is
+     * only touched on data path.
+     */
+    void DropUnmatchedPublication(::dds::sub::DataReader<MSG>& reader)
+    {
+        dds_entity_t entity = reader->get_ddsc_entity();
+
+        dds_return_t count = dds_get_matched_publications(entity, NULL, 0);
+        if (count < 0)
+        {
+            return;
+        }
+
+        std::vector<dds_instance_handle_t> handles(count);
+        count = dds_get_matched_publications(entity, handles.data(), handles.size());
+        if (count < 0)
+        {
+            return;
+        }
+
+        handles.resize(std::min<size_t>(count, handles.size()));
+
+        auto iter = mPublicationFilterCache.begin();
+        while (iter != mPublicationFilterCache.end())
+        {
+            if (std::find(handles.begin(), handles.end(), iter->first) == handles.end())
+            {
+                iter = mPublicationFilterCache.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    void on_subscription_matched(::dds::sub::DataReader<MSG>&, const ::dds::core::status::SubscriptionMatchedStatus& status)
+    {
+        if (status.current_count_change() < 0)
+        {
+            mPublicationUnmatched.store(true);
+        }
+    }
+
     void on_data_available(::dds::sub::DataReader<MSG>& reader)
     {
         ::dds::sub::LoanedSamples<MSG> samples;
@@ -320,18 +947,26 @@ private:
             const MSG& m = iter->data();
             if (iter->info().valid())
             {
-                mLastDataAvailableTime = GetCurrentMonotonicTimeNanosecond();
+                if (mPublicationFilter && IsPublicationFiltered(reader, iter->info().publication_handle()))
+                {
+                    continue;
+                }
+
+                mLastDataAvailableTime.store(GetCurrentMonotonicTimeNanosecond(), std::memory_order_relaxed);
 
                 if (mHasQueue)
                 {
-                    if (!mDataQueuePtr->Put(MSG_PTR(new MSG(m)), true))
-                    {
-                        LOG_WARNING(mLogger, "earliest mesage was evicted. type:", DdsGetTypeName(MSG));
-                    }
+                    Enqueue(m);
+                }
+                else if (mLoanedHandler)
+                {
+                    mLoanedHandler(DdsLoanedMessage<MSG>(samples, (uint32_t)(iter - samples.begin())));
                 }
                 else
                 {
-                    mCallbackPtr->OnDataAvailable((const void*)&m);
+                    SerializeDelivery([this, &m]() {
+                        OnMessage(m);
+                    });
                 }
             }
         }
@@ -342,11 +977,23 @@ private:
     volatile bool mQuit;
 
     ::dds::core::status::StatusMask mMask;
-    int64_t mLastDataAvailableTime;
+    std::atomic<int64_t> mLastDataAvailableTime;
+
+    Mutex mDeliveryMutex;
+    std::atomic<pthread_t> mDeliveryThread;
 
     DdsReaderCallbackPtr mCallbackPtr;
-    BlockQueuePtr<MSG_PTR> mDataQueuePtr;
+    DdsTypedMessageHandler<MSG> mTypedHandler;
+    DdsLoanedMessageHandler<MSG> mLoanedHandler;
+    std::function<bool(const dds_guid_t&)> mPublicationFilter;
+    std::unordered_map<dds_instance_handle_t,bool> mPublicationFilterCache;
+    std::atomic<bool> mPublicationUnmatched;
+    RingQueuePtr<MSG> mDataQueuePtr;
     ThreadPtr mDataQueueThreadPtr;
+
+    std::string mExecutorClass;
+    DdsExecutorClassPtr mExecutorClassPtr;
+    DdsExecutorSourcePtr mExecutorSourcePtr;
 };
 
 template<typename MSG>
@@ -362,7 +1009,10 @@ class DdsReader : public DdsLogger
 public:
     using NATIVE_TYPE = ::dds::sub::DataReader<MSG>;
 
-    explicit DdsReader(const DdsSubscriberPtr& subscriber, const DdsTopicPtr<MSG>& topic, const DdsReaderQos& qos) :
+    /*
+     * keepLatest: history is KEEP_LAST(1) whatever qos says, for polling reader.
+     */
+    explicit DdsReader(const DdsSubscriberPtr& subscriber, const DdsTopicPtr<MSG>& topic, const DdsReaderQos& qos, bool keepLatest = false) :
         mNative(__UT_DDS_NULL__)
     {
         UT_DDS_EXCEPTION_TRY
@@ -370,6 +1020,11 @@ public:
         auto readerQos = subscriber->GetNative().default_datareader_qos();
         qos.CopyToNativeQos(readerQos);
 
+        if (keepLatest)
+        {
+            readerQos << ::dds::core::policy::History::KeepLast(1);
+        }
+
         mNative = NATIVE_TYPE(subscriber->GetNative(), topic->GetNative(), readerQos);
 
         UT_DDS_EXCEPTION_CATCH(mLogger, true)
@@ -385,6 +1040,11 @@ public:
         return mNative;
     }
 
+    void SetExecutorClass(const std::string& name)
+    {
+        mListener.SetExecutorClass(name);
+    }
+
     void SetListener(const DdsReaderCallback& cb, int32_t qlen)
     {
         mListener.SetCallback(cb);
@@ -392,11 +1052,102 @@ public:
         mNative.listener(mListener.GetNative(), mListener.GetStatusMask());
     }
 
+    void SetListener(const DdsTypedMessageHandler<MSG>& handler, int32_t qlen)
+    {
+        mListener.SetTypedHandler(handler);
+        mListener.SetQueue(qlen);
+        mNative.listener(mListener.GetNative(), mListener.GetStatusMask());
+    }
+
+    void SetListener(const DdsLoanedMessageHandler<MSG>& handler)
+    {
+        mListener.SetLoanedHandler(handler);
+        mNative.listener(mListener.GetNative(), mListener.GetStatusMask());
+    }
+
     int64_t GetLastDataAvailableTime() const
     {
         return mListener.GetLastDataAvailableTime();
     }
 
+    uint64_t GetEvictedCount() const
+    {
+        return mListener.GetEvictedCount();
+    }
+
+    bool GetGuid(dds_guid_t& guid)
+    {
+        return dds_get_guid(mNative->get_ddsc_entity(), &guid) == DDS_RETCODE_OK;
+    }
+
+    /*
+     * Whether reader keeps only the latest sample, KEEP_LAST(1).
+     */
+    bool IsKeepLatest() const
+    {
+        const ::dds::core::policy::History& history = mNative.qos().template policy<::dds::core::policy::History>();
+        return history.kind() == ::dds::core::policy::HistoryKind::KEEP_LAST && history.depth() == 1;
+    }
+
+    void SetPublicationFilter(const std::function<bool(const dds_guid_t&)>& filter)
+    {
+        mListener.SetPublicationFilter(filter);
+    }
+
+    void Deliver(const MSG& message)
+    {
+        mListener.Deliver(message);
+    }
+
+    /*
+     * Take the newest sample not read yet on caller's thread, it is removed
+     * from reader cache. sourceTimestamp is writer's time in nanosecond.
+     */
+    bool TakeLatest(MSG& message, int64_t& sourceTimestamp)
+    {
+        return CopyLatest(mNative.select().state(::dds::sub::status::DataState::new_data()).take(), message, sourceTimestamp, NULL);
+    }
+
+    /*
+     * Copy the newest sample in reader cache on caller's thread, isNew is
+     * false if it was read before. A taken sample is no longer in cache.
+     */
+    bool ReadLatest(MSG& message, int64_t& sourceTimestamp, bool& isNew)
+    {
+        return CopyLatest(mNative.read(), message, sourceTimestamp, &isNew);
+    }
+
+private:
+    bool CopyLatest(const ::dds::sub::LoanedSamples<MSG>& samples, MSG& message, int64_t& sourceTimestamp, bool* isNew)
+    {
+        typename ::dds::sub::LoanedSamples<MSG>::const_iterator latest = samples.end();
+        typename ::dds::sub::LoanedSamples<MSG>::const_iterator iter;
+
+        for (iter=samples.begin(); iter<samples.end(); ++iter)
+        {
+            if (iter->info().valid() && (latest == samples.end() || latest->info().timestamp() < iter->info().timestamp()))
+            {
+                latest = iter;
+            }
+        }
+
+        if (latest == samples.end())
+        {
+            return false;
+        }
+
+        const ::dds::core::Time& timestamp = latest->info().timestamp();
+
+        message = latest->data();
+        sourceTimestamp = timestamp.sec() * 1000000000LL + timestamp.nanosec();
+        if (isNew != NULL)
+        {
+            *isNew = latest->info().state().sample_state() == ::dds::sub::status::SampleState::not_read();
+        }
+
+        return true;
+    }
+
 private:
     NATIVE_TYPE mNative;
     DdsReaderListener<MSG> mListener;
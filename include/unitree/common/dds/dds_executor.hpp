@@ -0,0 +1,393 @@
+#ifndef __UT_DDS_EXECUTOR_HPP__
+#define __UT_DDS_EXECUTOR_HPP__
+
+#include <deque>
+#include <unitree/common/exception.hpp>
+#include <unitree/common/json/json.hpp>
+#include <unitree/common/log/log.hpp>
+#include <unitree/common/thread/thread.hpp>
+
+#define UT_DDS_EXECUTOR_DEFAULT_CLASS       "default"
+#define UT_DDS_EXECUTOR_QUEUE_LEN           16
+#define UT_DDS_EXECUTOR_DISPATCH_BATCH      8
+#define UT_DDS_EXECUTOR_WAIT_MICROSEC       1000000
+
+#define UT_DDS_EXECUTOR_KEY_NAME            "Name"
+#define UT_DDS_EXECUTOR_KEY_THREADNUMBER    "ThreadNumber"
+#define UT_DDS_EXECUTOR_KEY_CPUSET          "CpuSet"
+#define UT_DDS_EXECUTOR_KEY_PRIORITY        "Priority"
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: DdsExecutorClassConfig
+ *         Named priority class of the dispatcher pool. Threads of the class
+ *         are pinned to cpuSet and run SCHED_FIFO at priority, priority 0
+ *         keeps the default scheduler.
+ */
+struct DdsExecutorClassConfig
+{
+    DdsExecutorClassConfig() :
+        threadNumber(1), priority(0)
+    {}
+
+    DdsExecutorClassConfig(const std::string& name, uint32_t threadNumber = 1, const std::vector<int32_t>& cpuSet = {}, int32_t priority = 0) :
+        name(name), threadNumber(threadNumber), cpuSet(cpuSet), priority(priority)
+    {}
+
+    bool operator==(const DdsExecutorClassConfig& other) const
+    {
+        return name == other.name && threadNumber == other.threadNumber &&
+            cpuSet == other.cpuSet && priority == other.priority;
+    }
+
+    std::string name;
+    uint32_t threadNumber;
+    std::vector<int32_t> cpuSet;
+    int32_t priority;
+};
+
+using DdsExecutorConfig = std::vector<DdsExecutorClassConfig>;
+
+/*
+ * Parse executor config from json array:
+ * [{"Name":"rt", "ThreadNumber":1, "CpuSet":[2,3], "Priority":80}, ...]
+ */
+static inline DdsExecutorConfig DdsExecutorConfigFromJson(const Any& value)
+{
+    DdsExecutorConfig config;
+
+    if (!IsJsonArray(value))
+    {
+        UT_THROW(CommonException, "executor config is not json array");
+    }
+
+    const JsonArray& classArray = AnyCast<JsonArray>(value);
+    for (const Any& classValue : classArray)
+    {
+        if (!IsJsonMap(classValue))
+        {
+            UT_THROW(CommonException, "executor class config is not json object");
+        }
+
+        const JsonMap& classMap = AnyCast<JsonMap>(classValue);
+        DdsExecutorClassConfig classConfig;
+
+        JsonMap::const_iterator iter = classMap.find(UT_DDS_EXECUTOR_KEY_NAME);
+        if (iter == classMap.end() || !IsString(iter->second))
+        {
+            UT_THROW(CommonException, "executor class name is not specified");
+        }
+        classConfig.name = AnyCast<std::string>(iter->second);
+
+        iter = classMap.find(UT_DDS_EXECUTOR_KEY_THREADNUMBER);
+        if (iter != classMap.end())
+        {
+            classConfig.threadNumber = AnyNumberCast<uint32_t>(iter->second);
+        }
+
+        iter = classMap.find(UT_DDS_EXECUTOR_KEY_PRIORITY);
+        if (iter != classMap.end())
+        {
+            classConfig.priority = AnyNumberCast<int32_t>(iter->second);
+        }
+
+        iter = classMap.find(UT_DDS_EXECUTOR_KEY_CPUSET);
+        if (iter != classMap.end() && IsJsonArray(iter->second))
+        {
+            for (const Any& cpu : AnyCast<JsonArray>(iter->second))
+            {
+                classConfig.cpuSet.push_back(AnyNumberCast<int32_t>(cpu));
+            }
+        }
+
+        config.push_back(classConfig);
+    }
+
+    return config;
+}
+
+/*
+ * @brief: DdsExecutorSource
+ *         Pending messages of one reader. A source is dispatched by at most
+ *         one thread at a time, so messages of a reader keep their order.
+ */
+class DdsExecutorSource
+{
+public:
+    explicit DdsExecutorSource() :
+        mScheduled(false), mClosed(false)
+    {}
+
+    virtual ~DdsExecutorSource()
+    {}
+
+    /*
+     * true if source was not scheduled and caller should post it.
+     */
+    bool Schedule()
+    {
+        return !mScheduled.exchange(true);
+    }
+
+    void Unschedule()
+    {
+        mScheduled.store(false);
+    }
+
+    void Dispatch(uint32_t max)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        if (!mClosed)
+        {
+            DispatchPending(max);
+        }
+    }
+
+    bool HasPending()
+    {
+        return !mClosed && HasPendingMessage();
+    }
+
+    /*
+     * Wait running dispatch and stop further dispatch.
+     */
+    void Close()
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mClosed = true;
+    }
+
+protected:
+    virtual void DispatchPending(uint32_t max) = 0;
+    virtual bool HasPendingMessage() = 0;
+
+private:
+    std::atomic<bool> mScheduled;
+    volatile bool mClosed;
+    Mutex mMutex;
+};
+
+using DdsExecutorSourcePtr = std::shared_ptr<DdsExecutorSource>;
+
+/*
+ * @brief: DdsExecutorClass
+ */
+class DdsExecutorClass
+{
+public:
+    explicit DdsExecutorClass(const DdsExecutorClassConfig& config) :
+        mQuit(false), mConfig(config)
+    {
+        mLogger = GetLogger("/unitree/dds/executor");
+
+        if (mConfig.threadNumber == 0)
+        {
+            mConfig.threadNumber = 1;
+        }
+
+        for (uint32_t i=0; i<mConfig.threadNumber; i++)
+        {
+            mThreadList.push_back(CreateThreadEx("dexec", UT_CPU_ID_NONE, &DdsExecutorClass::ThreadFunction, this));
+        }
+    }
+
+    ~DdsExecutorClass()
+    {
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mQuit = true;
+            mMutexCond.NotifyAll();
+        }
+
+        for (ThreadPtr& threadPtr : mThreadList)
+        {
+            threadPtr->Wait();
+        }
+    }
+
+    const DdsExecutorClassConfig& GetConfig() const
+    {
+        return mConfig;
+    }
+
+    void Schedule(const DdsExecutorSourcePtr& sourcePtr)
+    {
+        if (!sourcePtr->Schedule())
+        {
+            return;
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        mReadyQueue.push_back(sourcePtr);
+        mMutexCond.Notify();
+    }
+
+private:
+    int32_t ThreadFunction()
+    {
+        SetSchedule();
+
+        while (true)
+        {
+            DdsExecutorSourcePtr sourcePtr;
+
+            {
+                LockGuard<MutexCond> guard(mMutexCond);
+                while (mReadyQueue.empty() && !mQuit)
+                {
+                    mMutexCond.Wait(UT_DDS_EXECUTOR_WAIT_MICROSEC);
+                }
+
+                if (mQuit)
+                {
+                    break;
+                }
+
+                sourcePtr = mReadyQueue.front();
+                mReadyQueue.pop_front();
+            }
+
+            /*
+             * dispatch a batch then requeue, readers of one class share threads fairly.
+             */
+            sourcePtr->Dispatch(UT_DDS_EXECUTOR_DISPATCH_BATCH);
+            sourcePtr->Unschedule();
+
+            if (sourcePtr->HasPending())
+            {
+                Schedule(sourcePtr);
+            }
+        }
+
+        return 0;
+    }
+
+    void SetSchedule()
+    {
+        if (!mConfig.cpuSet.empty())
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+
+            for (int32_t cpu : mConfig.cpuSet)
+            {
+                CPU_SET(cpu, &cpuSet);
+            }
+
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0)
+            {
+                LOG_WARNING(mLogger, "set executor thread affinity failed. class:", mConfig.name);
+            }
+        }
+
+        if (mConfig.priority > 0)
+        {
+            struct sched_param param;
+            param.sched_priority = mConfig.priority;
+
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+            {
+                LOG_WARNING(mLogger, "set executor thread SCHED_FIFO failed. class:", mConfig.name, ", priority:", mConfig.priority);
+            }
+        }
+    }
+
+private:
+    volatile bool mQuit;
+    DdsExecutorClassConfig mConfig;
+
+    MutexCond mMutexCond;
+    std::deque<DdsExecutorSourcePtr> mReadyQueue;
+    std::vector<ThreadPtr> mThreadList;
+
+    Logger* mLogger;
+};
+
+using DdsExecutorClassPtr = std::shared_ptr<DdsExecutorClass>;
+
+/*
+ * @brief: DdsExecutor
+ *         Process-wide dispatcher pool of reader queues. Queued readers
+ *         without class use the "default" class if configured, otherwise
+ *         a dedicated thread each.
+ */
+class DdsExecutor
+{
+public:
+    static DdsExecutor* Instance()
+    {
+        static DdsExecutor inst;
+        return &inst;
+    }
+
+    /*
+     * Classes already created with the same config are kept, so Init may be
+     * called again with the same config. A class of another config throws
+     * and nothing of config is created.
+     */
+    void Init(const DdsExecutorConfig& config)
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        for (size_t i=0; i<config.size(); i++)
+        {
+            const DdsExecutorClassConfig& classConfig = config[i];
+
+            if (classConfig.name.empty())
+            {
+                UT_THROW(CommonException, "executor class name is empty");
+            }
+
+            for (size_t j=0; j<i; j++)
+            {
+                if (config[j].name == classConfig.name)
+                {
+                    UT_THROW(CommonException, std::string("executor class is duplicated: ") + classConfig.name);
+                }
+            }
+
+            auto iter = mClassMap.find(classConfig.name);
+            if (iter != mClassMap.end() && !(iter->second->GetConfig() == classConfig))
+            {
+                UT_THROW(CommonException, std::string("executor class is already exist with another config: ") + classConfig.name);
+            }
+        }
+
+        for (const DdsExecutorClassConfig& classConfig : config)
+        {
+            if (mClassMap.find(classConfig.name) == mClassMap.end())
+            {
+                mClassMap[classConfig.name] = DdsExecutorClassPtr(new DdsExecutorClass(classConfig));
+            }
+        }
+    }
+
+    DdsExecutorClassPtr GetClass(const std::string& name)
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        auto iter = mClassMap.find(name);
+        if (iter == mClassMap.end())
+        {
+            return DdsExecutorClassPtr();
+        }
+
+        return iter->second;
+    }
+
+private:
+    DdsExecutor()
+    {}
+
+private:
+    Mutex mMutex;
+    std::map<std::string,DdsExecutorClassPtr> mClassMap;
+};
+
+}
+}
+
+#endif//__UT_DDS_EXECUTOR_HPP__
@@ -3,6 +3,7 @@
 
 #include <unitree/common/dds/dds_parameter.hpp>
 #include <unitree/common/dds/dds_topic_channel.hpp>
+#include <unitree/common/dds/dds_rpc_channel.hpp>
 
 namespace unitree
 {
@@ -26,6 +27,18 @@ public:
         return channel;
     }
 
+    /*
+     * Topic channel with qos profile applied over the factory qos.
+     */
+    template<typename MSG>
+    DdsTopicChannelPtr<MSG> CreateTopicChannel(const std::string& topic, const DdsQosProfilePtr& profilePtr)
+    {
+        DdsTopicChannelPtr<MSG> channel = DdsTopicChannelPtr<MSG>(new DdsTopicChannel<MSG>());
+        channel->SetQosProfile(profilePtr);
+        channel->SetTopic(mParticipant, topic, mTopicQos);
+        return channel;
+    }
+
     template<typename MSG>
     void SetWriter(DdsTopicChannelPtr<MSG>& channelPtr)
     {
@@ -39,6 +52,45 @@ public:
         channelPtr->SetReader(mSubscriber, mReaderQos, cb, queuelen);
     }
 
+    template<typename MSG>
+    void SetTypedReader(DdsTopicChannelPtr<MSG>& channelPtr, const DdsTypedMessageHandler<MSG>& handler, int32_t queuelen = 0)
+    {
+        channelPtr->SetReader(mSubscriber, mReaderQos, handler, queuelen);
+    }
+
+    template<typename MSG>
+    void SetLoanedReader(DdsTopicChannelPtr<MSG>& channelPtr, const DdsLoanedMessageHandler<MSG>& handler)
+    {
+        channelPtr->SetReader(mSubscriber, mReaderQos, handler);
+    }
+
+    template<typename MSG>
+    void SetPollingReader(DdsTopicChannelPtr<MSG>& channelPtr)
+    {
+        channelPtr->SetPollingReader(mSubscriber, mReaderQos);
+    }
+
+    template<typename MSG>
+    DdsRpcChannelPtr<MSG> CreateRpcChannel(const std::string& topic, const DdsQosProfilePtr& profilePtr)
+    {
+        DdsRpcChannelPtr<MSG> channel = DdsRpcChannelPtr<MSG>(new DdsRpcChannel<MSG>());
+        channel->SetQosProfile(profilePtr);
+        channel->SetTopic(mParticipant, topic, mTopicQos);
+        return channel;
+    }
+
+    template<typename MSG>
+    void SetRpcWriter(DdsRpcChannelPtr<MSG>& channelPtr)
+    {
+        channelPtr->SetWriter(mPublisher, mWriterQos);
+    }
+
+    template<typename MSG>
+    void SetRpcReader(DdsRpcChannelPtr<MSG>& channelPtr, const DdsTypedMessageHandler<MSG>& handler)
+    {
+        channelPtr->SetReader(mSubscriber, mReaderQos, handler);
+    }
+
 private:
     DdsParticipantPtr mParticipant;
     DdsPublisherPtr mPublisher;
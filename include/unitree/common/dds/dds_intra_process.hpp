@@ -0,0 +1,181 @@
+#ifndef __UT_DDS_INTRA_PROCESS_HPP__
+#define __UT_DDS_INTRA_PROCESS_HPP__
+
+#include <unitree/common/dds/dds_entity.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: DdsIntraProcessTopic
+ *         Readers and writers of one topic in this process. Writers hand
+ *         messages to the readers directly, without dds serialization.
+ */
+template<typename MSG>
+class DdsIntraProcessTopic
+{
+public:
+    using READER_LIST = std::vector<DdsReaderPtr<MSG>>;
+    using READER_LIST_PTR = std::shared_ptr<const READER_LIST>;
+
+    explicit DdsIntraProcessTopic() :
+        mReaderListPtr(new READER_LIST()), mReaderGeneration(0)
+    {}
+
+    void AddReader(const DdsReaderPtr<MSG>& reader)
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        std::shared_ptr<READER_LIST> readerListPtr(new READER_LIST(*mReaderListPtr));
+        readerListPtr->push_back(reader);
+
+        std::atomic_store(&mReaderListPtr, READER_LIST_PTR(readerListPtr));
+
+        dds_guid_t guid;
+        if (reader->GetGuid(guid))
+        {
+            mReaderGuidList.push_back(guid);
+        }
+
+        mReaderGeneration.fetch_add(1);
+    }
+
+    void RemoveReader(const DdsReaderPtr<MSG>& reader)
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        std::shared_ptr<READER_LIST> readerListPtr(new READER_LIST(*mReaderListPtr));
+        readerListPtr->erase(std::remove(readerListPtr->begin(), readerListPtr->end(), reader), readerListPtr->end());
+
+        std::atomic_store(&mReaderListPtr, READER_LIST_PTR(readerListPtr));
+
+        dds_guid_t guid;
+        if (reader->GetGuid(guid))
+        {
+            RemoveGuid(mReaderGuidList, guid);
+        }
+
+        mReaderGeneration.fetch_add(1);
+    }
+
+    void AddWriter(const dds_guid_t& guid)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mWriterList.push_back(guid);
+    }
+
+    void RemoveWriter(const dds_guid_t& guid)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        RemoveGuid(mWriterList, guid);
+    }
+
+    bool IsWriter(const dds_guid_t& guid)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        return FindGuid(mWriterList, guid) != mWriterList.end();
+    }
+
+    /*
+     * Whether dds reader of guid is a reader of this topic.
+     */
+    bool IsReader(const dds_guid_t& guid)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        return FindGuid(mReaderGuidList, guid) != mReaderGuidList.end();
+    }
+
+    /*
+     * Changed when a reader is added or removed.
+     */
+    uint32_t GetReaderGeneration() const
+    {
+        return mReaderGeneration.load();
+    }
+
+    /*
+     * Deliver message to all readers on caller's thread.
+     * return count of readers delivered.
+     */
+    uint32_t Deliver(const MSG& message)
+    {
+        READER_LIST_PTR readerListPtr = std::atomic_load(&mReaderListPtr);
+
+        for (const DdsReaderPtr<MSG>& reader : *readerListPtr)
+        {
+            reader->Deliver(message);
+        }
+
+        return (uint32_t)readerListPtr->size();
+    }
+
+private:
+    static std::vector<dds_guid_t>::iterator FindGuid(std::vector<dds_guid_t>& list, const dds_guid_t& guid)
+    {
+        return std::find_if(list.begin(), list.end(), [&guid](const dds_guid_t& g) {
+            return memcmp(&g, &guid, sizeof(dds_guid_t)) == 0;
+        });
+    }
+
+    static void RemoveGuid(std::vector<dds_guid_t>& list, const dds_guid_t& guid)
+    {
+        auto iter = FindGuid(list, guid);
+        if (iter != list.end())
+        {
+            list.erase(iter);
+        }
+    }
+
+private:
+    Mutex mMutex;
+    READER_LIST_PTR mReaderListPtr;
+    std::vector<dds_guid_t> mReaderGuidList;
+    std::vector<dds_guid_t> mWriterList;
+    std::atomic<uint32_t> mReaderGeneration;
+};
+
+template<typename MSG>
+using DdsIntraProcessTopicPtr = std::shared_ptr<DdsIntraProcessTopic<MSG>>;
+
+/*
+ * @brief: DdsIntraProcessRegistry
+ */
+template<typename MSG>
+class DdsIntraProcessRegistry
+{
+public:
+    static DdsIntraProcessRegistry* Instance()
+    {
+        static DdsIntraProcessRegistry inst;
+        return &inst;
+    }
+
+    DdsIntraProcessTopicPtr<MSG> GetTopic(uint32_t domainId, const std::string& name)
+    {
+        std::string key = std::to_string(domainId) + ":" + name;
+
+        LockGuard<Mutex> guard(mMutex);
+
+        DdsIntraProcessTopicPtr<MSG>& topicPtr = mTopicMap[key];
+        if (!topicPtr)
+        {
+            topicPtr.reset(new DdsIntraProcessTopic<MSG>());
+        }
+
+        return topicPtr;
+    }
+
+private:
+    DdsIntraProcessRegistry()
+    {}
+
+private:
+    Mutex mMutex;
+    std::map<std::string,DdsIntraProcessTopicPtr<MSG>> mTopicMap;
+};
+
+}
+}
+
+#endif//__UT_DDS_INTRA_PROCESS_HPP__
@@ -0,0 +1,180 @@
+#ifndef __UT_DDS_QOS_PROFILE_HPP__
+#define __UT_DDS_QOS_PROFILE_HPP__
+
+#include <fnmatch.h>
+#include <unitree/common/lock/lock.hpp>
+#include <unitree/common/dds/dds_parameter.hpp>
+#include <unitree/common/dds/dds_qos_realize.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: DdsQosProfile
+ *         Topic, writer and reader qos of topics matching a name or a
+ *         glob pattern, applied over the factory default qos.
+ */
+class DdsQosProfile
+{
+public:
+    explicit DdsQosProfile(const std::string& pattern) :
+        mPattern(pattern), mHasTopicQos(false), mHasWriterQos(false), mHasReaderQos(false)
+    {}
+
+    const std::string& GetPattern() const
+    {
+        return mPattern;
+    }
+
+    void SetTopicQos(const DdsQosParameter& qos)
+    {
+        mTopicQos = qos;
+        mHasTopicQos = true;
+    }
+
+    void SetWriterQos(const DdsQosParameter& qos)
+    {
+        mWriterQos = qos;
+        mHasWriterQos = true;
+    }
+
+    void SetReaderQos(const DdsQosParameter& qos)
+    {
+        mReaderQos = qos;
+        mHasReaderQos = true;
+    }
+
+    void Apply(DdsTopicQos& qos) const
+    {
+        if (mHasTopicQos)
+        {
+            Realize(mTopicQos, qos);
+        }
+    }
+
+    void Apply(DdsWriterQos& qos) const
+    {
+        if (mHasWriterQos)
+        {
+            Realize(mWriterQos, qos);
+        }
+    }
+
+    void Apply(DdsReaderQos& qos) const
+    {
+        if (mHasReaderQos)
+        {
+            Realize(mReaderQos, qos);
+        }
+    }
+
+private:
+    std::string mPattern;
+
+    bool mHasTopicQos;
+    bool mHasWriterQos;
+    bool mHasReaderQos;
+
+    DdsQosParameter mTopicQos;
+    DdsQosParameter mWriterQos;
+    DdsQosParameter mReaderQos;
+};
+
+using DdsQosProfilePtr = std::shared_ptr<DdsQosProfile>;
+
+/*
+ * @brief: DdsQosProfileSet
+ *         Profiles are read from the per-topic sections of dds parameter:
+ *         "Topic" entries by name, "Publisher"/"Writer" and
+ *         "Subscriber"/"Reader" entries by topic name. A name may be a
+ *         fnmatch pattern, exact name wins, otherwise the longest matching
+ *         pattern.
+ */
+class DdsQosProfileSet
+{
+public:
+    DdsQosProfileSet()
+    {}
+
+    void Init(const JsonMap& param)
+    {
+        DdsParameter parameter(param);
+
+        LockGuard<Mutex> guard(mMutex);
+
+        for (const auto& topic : parameter.GetTopic())
+        {
+            if (!topic.second.GetQos().Default())
+            {
+                GetProfile(topic.first)->SetTopicQos(topic.second.GetQos());
+            }
+        }
+
+        for (const DdsPublisherParameter& publisher : parameter.GetPublisher())
+        {
+            for (const DdsWriterParameter& writer : publisher.GetWriter())
+            {
+                if (!writer.GetTopicName().empty() && !writer.GetQos().Default())
+                {
+                    GetProfile(writer.GetTopicName())->SetWriterQos(writer.GetQos());
+                }
+            }
+        }
+
+        for (const DdsSubscriberParameter& subscriber : parameter.GetSubscriber())
+        {
+            for (const DdsReaderParameter& reader : subscriber.GetReader())
+            {
+                if (!reader.GetTopicName().empty() && !reader.GetQos().Default())
+                {
+                    GetProfile(reader.GetTopicName())->SetReaderQos(reader.GetQos());
+                }
+            }
+        }
+    }
+
+    DdsQosProfilePtr Find(const std::string& topic)
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        auto iter = mProfileMap.find(topic);
+        if (iter != mProfileMap.end())
+        {
+            return iter->second;
+        }
+
+        DdsQosProfilePtr profilePtr;
+        for (iter = mProfileMap.begin(); iter != mProfileMap.end(); ++iter)
+        {
+            if ((!profilePtr || iter->first.size() > profilePtr->GetPattern().size()) &&
+                fnmatch(iter->first.c_str(), topic.c_str(), 0) == 0)
+            {
+                profilePtr = iter->second;
+            }
+        }
+
+        return profilePtr;
+    }
+
+private:
+    DdsQosProfilePtr GetProfile(const std::string& pattern)
+    {
+        DdsQosProfilePtr& profilePtr = mProfileMap[pattern];
+        if (!profilePtr)
+        {
+            profilePtr.reset(new DdsQosProfile(pattern));
+        }
+
+        return profilePtr;
+    }
+
+private:
+    Mutex mMutex;
+    std::map<std::string,DdsQosProfilePtr> mProfileMap;
+};
+
+}
+}
+
+#endif//__UT_DDS_QOS_PROFILE_HPP__
@@ -0,0 +1,179 @@
+#ifndef __UT_DDS_RPC_CHANNEL_HPP__
+#define __UT_DDS_RPC_CHANNEL_HPP__
+
+#include <unitree/common/dds/dds_entity.hpp>
+#include <unitree/common/dds/dds_qos_profile.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: DdsRpcReaderListener
+ */
+template<typename MSG>
+class DdsRpcReaderListener : public ::dds::sub::NoOpDataReaderListener<MSG>
+{
+public:
+    explicit DdsRpcReaderListener(const DdsTypedMessageHandler<MSG>& handler) :
+        mHandler(handler)
+    {}
+
+    void on_data_available(::dds::sub::DataReader<MSG>& reader)
+    {
+        ::dds::sub::LoanedSamples<MSG> samples = reader.take();
+
+        for (auto iter = samples.begin(); iter < samples.end(); ++iter)
+        {
+            if (iter->info().valid())
+            {
+                mHandler(iter->data());
+            }
+        }
+    }
+
+private:
+    DdsTypedMessageHandler<MSG> mHandler;
+};
+
+/*
+ * @brief: DdsRpcChannel
+ *         Writer or reader of an rpc topic used by header code, request or
+ *         response of services. The client and server stubs of the library
+ *         instantiate DdsTopicChannel, DdsWriter and DdsReaderListener of
+ *         these messages with their own layout, so those templates are not
+ *         instantiated for them here. Handler is called on dds listener
+ *         thread, without queue, shm or intra-process delivery.
+ */
+template<typename MSG>
+class DdsRpcChannel : public DdsLogger
+{
+public:
+    explicit DdsRpcChannel() :
+        mTopic(__UT_DDS_NULL__), mWriter(__UT_DDS_NULL__), mReader(__UT_DDS_NULL__)
+    {}
+
+    ~DdsRpcChannel()
+    {
+        mMatchedStatus.Detach();
+
+        if (mReader != __UT_DDS_NULL__)
+        {
+            //waits for listener calls running
+            mReader.listener(NULL, ::dds::core::status::StatusMask::none());
+            mReader = __UT_DDS_NULL__;
+        }
+
+        mWriter = __UT_DDS_NULL__;
+        mTopic = __UT_DDS_NULL__;
+    }
+
+    /*
+     * Qos profile of topic applied over the qos given to topic, writer and
+     * reader. Must be set before topic.
+     */
+    void SetQosProfile(const DdsQosProfilePtr& profilePtr)
+    {
+        mQosProfilePtr = profilePtr;
+    }
+
+    void SetTopic(const DdsParticipantPtr& participant, const std::string& name, const DdsTopicQos& qos)
+    {
+        UT_DDS_EXCEPTION_TRY
+
+        auto topicQos = participant->GetNative().default_topic_qos();
+        ApplyQosProfile(qos).CopyToNativeQos(topicQos);
+
+        mTopic = ::dds::topic::Topic<MSG>(participant->GetNative(), name, topicQos);
+
+        UT_DDS_EXCEPTION_CATCH(mLogger, true)
+    }
+
+    void SetWriter(const DdsPublisherPtr& publisher, const DdsWriterQos& qos)
+    {
+        UT_DDS_EXCEPTION_TRY
+
+        auto writerQos = publisher->GetNative().default_datawriter_qos();
+        ApplyQosProfile(qos).CopyToNativeQos(writerQos);
+
+        mWriter = ::dds::pub::DataWriter<MSG>(publisher->GetNative(), mTopic, writerQos);
+        mMatchedStatus.Attach(mWriter->get_ddsc_entity());
+
+        UT_DDS_EXCEPTION_CATCH(mLogger, true)
+    }
+
+    void SetReader(const DdsSubscriberPtr& subscriber, const DdsReaderQos& qos, const DdsTypedMessageHandler<MSG>& handler)
+    {
+        UT_DDS_EXCEPTION_TRY
+
+        auto readerQos = subscriber->GetNative().default_datareader_qos();
+        ApplyQosProfile(qos).CopyToNativeQos(readerQos);
+
+        mListenerPtr.reset(new DdsRpcReaderListener<MSG>(handler));
+        mReader = ::dds::sub::DataReader<MSG>(subscriber->GetNative(), mTopic, readerQos,
+            mListenerPtr.get(), ::dds::core::status::StatusMask::data_available());
+
+        UT_DDS_EXCEPTION_CATCH(mLogger, true)
+    }
+
+    /*
+     * Write message, waiting a reader matched for at most half of
+     * waitMicrosec as DdsWriter does.
+     */
+    bool Write(const MSG& message, int64_t waitMicrosec)
+    {
+        UT_DDS_EXCEPTION_TRY
+        {
+            if (waitMicrosec >= __UT_DDS_WAIT_MATCHED_TIME_SLICE)
+            {
+                mMatchedStatus.Wait(1, std::min<int64_t>(waitMicrosec / 2, __UT_DDS_WAIT_MATCHED_TIME_MAX));
+            }
+
+            mWriter.write(message);
+            return true;
+        }
+        UT_DDS_EXCEPTION_CATCH(mLogger, false)
+
+        return false;
+    }
+
+    int32_t GetMatchedCount() const
+    {
+        return mMatchedStatus.GetMatchedCount();
+    }
+
+    bool WaitMatched(int32_t count, int64_t waitMicrosec)
+    {
+        return mMatchedStatus.Wait(count, waitMicrosec);
+    }
+
+private:
+    template<typename QOS>
+    QOS ApplyQosProfile(const QOS& qos) const
+    {
+        QOS profileQos = qos;
+        if (mQosProfilePtr)
+        {
+            mQosProfilePtr->Apply(profileQos);
+        }
+
+        return profileQos;
+    }
+
+private:
+    DdsQosProfilePtr mQosProfilePtr;
+
+    ::dds::topic::Topic<MSG> mTopic;
+    ::dds::pub::DataWriter<MSG> mWriter;
+    ::dds::sub::DataReader<MSG> mReader;
+    std::unique_ptr<DdsRpcReaderListener<MSG>> mListenerPtr;
+    DdsWriterMatchedStatus mMatchedStatus;
+};
+
+template<typename MSG>
+using DdsRpcChannelPtr = std::shared_ptr<DdsRpcChannel<MSG>>;
+
+}
+}
+
+#endif//__UT_DDS_RPC_CHANNEL_HPP__
@@ -0,0 +1,614 @@
+#ifndef __UT_DDS_SHM_TRANSPORT_HPP__
+#define __UT_DDS_SHM_TRANSPORT_HPP__
+
+#include <linux/futex.h>
+#include <sys/file.h>
+#include <dds/dds.hpp>
+#include <unitree/common/log/log.hpp>
+#include <unitree/common/thread/thread.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/common/dds/dds_traits.hpp>
+
+/*
+ * shared memory segment name prefix. segment name is
+ * prefix.domainId.topicName with '/' replaced by '.'
+ */
+#define UT_DDS_SHM_NAME_PREFIX          "/ut_dds_shm"
+
+#define UT_DDS_SHM_MAGIC                0x55544453
+#define UT_DDS_SHM_VERSION              2
+
+/*
+ * max same-host readers attached to one segment.
+ */
+#define UT_DDS_SHM_READER_SLOT_NUM      32
+
+/*
+ * reader is live if heartbeat within 1s.
+ */
+#define UT_DDS_SHM_READER_LIVE_NANOSEC  1000000000
+
+/*
+ * reader wait time slice, also heartbeat interval. 100ms
+ */
+#define UT_DDS_SHM_WAIT_TIME_SLICE      100000
+
+/*
+ * max time to wait segment initialized by another process. 1s
+ */
+#define UT_DDS_SHM_INIT_WAIT_MAX        1000000
+
+#define UT_DDS_SHM_READ_RETRY_MAX       64
+
+namespace unitree
+{
+namespace common
+{
+struct DdsShmReaderSlot
+{
+    std::atomic<int32_t> pid;
+    std::atomic<uint64_t> heartbeat;
+    dds_guid_t guid;
+};
+
+struct DdsShmHeader
+{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint64_t messageSize;
+    uint64_t typeHash;
+    std::atomic<int32_t> writerPid;
+    dds_guid_t writerGuid;
+    std::atomic<uint32_t> waiters;
+    /*
+     * changed when a reader is attached or detached.
+     */
+    std::atomic<uint32_t> readerGeneration;
+    /*
+     * seqlock sequence, odd while writing. also used as futex word.
+     */
+    alignas(64) std::atomic<uint32_t> sequence;
+    alignas(64) DdsShmReaderSlot readers[UT_DDS_SHM_READER_SLOT_NUM];
+};
+
+/*
+ * @brief: DdsShmSegment
+ *         Single writer, multiple reader mmap segment holding the latest
+ *         message of a topic, protected by a seqlock.
+ *         Every process keeps a shared flock of the segment while it is
+ *         open. Only a sole user gets the exclusive lock, so it initializes
+ *         a new segment or one left by a crashed or older process, and
+ *         unlinks the segment when it closes it.
+ */
+class DdsShmSegment
+{
+public:
+    explicit DdsShmSegment(const std::string& name, uint64_t messageSize, uint64_t typeHash) :
+        mName(name), mFd(-1), mSize(0), mMessageSize(messageSize), mTypeHash(typeHash),
+        mHeader(NULL), mPayload(NULL), mWriter(false), mReaderSlot(-1)
+    {}
+
+    ~DdsShmSegment()
+    {
+        Close();
+    }
+
+    static std::string MakeName(uint32_t domainId, const std::string& topic)
+    {
+        std::string name = std::string(UT_DDS_SHM_NAME_PREFIX) + "." + std::to_string(domainId) + ".";
+        for (char c : topic)
+        {
+            name += (c == '/') ? '.' : c;
+        }
+
+        return name;
+    }
+
+    static uint64_t MakeTypeHash(const std::string& typeName, uint64_t messageSize)
+    {
+        //FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : typeName)
+        {
+            hash = (hash ^ (uint8_t)c) * 1099511628211ULL;
+        }
+
+        return hash ^ messageSize;
+    }
+
+    bool Open()
+    {
+        mSize = PayloadOffset() + mMessageSize;
+
+        int64_t waitTime = UT_DDS_SHM_INIT_WAIT_MAX;
+        while (true)
+        {
+            int32_t ret = TryOpen();
+            if (ret >= 0)
+            {
+                return ret > 0;
+            }
+
+            if (waitTime <= 0)
+            {
+                return false;
+            }
+
+            usleep(1000);
+            waitTime -= 1000;
+        }
+    }
+
+    void Close()
+    {
+        if (mHeader != NULL)
+        {
+            if (mWriter)
+            {
+                mHeader->writerPid.store(0);
+            }
+
+            if (mReaderSlot >= 0)
+            {
+                mHeader->readers[mReaderSlot].pid.store(0);
+                mHeader->readerGeneration.fetch_add(1);
+                mReaderSlot = -1;
+            }
+
+            Unmap();
+        }
+
+        if (mFd >= 0)
+        {
+            //last user of segment removes it
+            if (flock(mFd, LOCK_EX | LOCK_NB) == 0)
+            {
+                shm_unlink(mName.c_str());
+            }
+
+            CloseFd();
+        }
+    }
+
+    /*
+     * Claim the only writer of segment. Owner of a dead process is replaced.
+     */
+    bool ClaimWriter(const dds_guid_t& guid)
+    {
+        int32_t pid = getpid();
+        int32_t owner = mHeader->writerPid.load();
+
+        while (true)
+        {
+            if (owner == pid || (owner != 0 && IsProcessAlive(owner)))
+            {
+                return false;
+            }
+
+            if (mHeader->writerPid.compare_exchange_weak(owner, pid))
+            {
+                break;
+            }
+        }
+
+        memcpy(&mHeader->writerGuid, &guid, sizeof(dds_guid_t));
+
+        //previous writer died while writing
+        uint32_t seq = mHeader->sequence.load();
+        if (seq & 1)
+        {
+            mHeader->sequence.store(seq + 1);
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+        mWriter = true;
+
+        return true;
+    }
+
+    /*
+     * Attach dds reader of guid, which is then served by segment.
+     */
+    bool AttachReader(const dds_guid_t& guid)
+    {
+        int32_t pid = getpid();
+
+        for (int32_t i=0; i<UT_DDS_SHM_READER_SLOT_NUM; i++)
+        {
+            DdsShmReaderSlot& slot = mHeader->readers[i];
+            int32_t owner = slot.pid.load();
+
+            if ((owner == 0 || !IsProcessAlive(owner)) && slot.pid.compare_exchange_strong(owner, pid))
+            {
+                mReaderSlot = i;
+                memcpy(&slot.guid, &guid, sizeof(dds_guid_t));
+                Heartbeat();
+                mHeader->readerGeneration.fetch_add(1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Heartbeat()
+    {
+        if (mReaderSlot >= 0)
+        {
+            mHeader->readers[mReaderSlot].heartbeat.store(GetCurrentMonotonicTimeNanosecond(), std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * Count of readers with heartbeat in time, readers of excludePid are not counted.
+     */
+    uint32_t GetLiveReaderCount(int32_t excludePid = 0) const
+    {
+        uint32_t count = 0;
+        uint64_t now = GetCurrentMonotonicTimeNanosecond();
+
+        for (int32_t i=0; i<UT_DDS_SHM_READER_SLOT_NUM; i++)
+        {
+            const DdsShmReaderSlot& slot = mHeader->readers[i];
+            int32_t pid = slot.pid.load(std::memory_order_relaxed);
+            if (pid != 0 && pid != excludePid &&
+                now - slot.heartbeat.load(std::memory_order_relaxed) < UT_DDS_SHM_READER_LIVE_NANOSEC)
+            {
+                count ++;
+            }
+        }
+
+        return count;
+    }
+
+    /*
+     * Whether dds reader of guid is attached by a live process.
+     */
+    bool IsReader(const dds_guid_t& guid) const
+    {
+        for (int32_t i=0; i<UT_DDS_SHM_READER_SLOT_NUM; i++)
+        {
+            const DdsShmReaderSlot& slot = mHeader->readers[i];
+            int32_t pid = slot.pid.load();
+            if (pid != 0 && memcmp(&slot.guid, &guid, sizeof(dds_guid_t)) == 0 && IsProcessAlive(pid))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    uint32_t GetReaderGeneration() const
+    {
+        return mHeader->readerGeneration.load();
+    }
+
+    int32_t GetWriterPid() const
+    {
+        return mHeader->writerPid.load();
+    }
+
+    bool IsWriter(const dds_guid_t& guid) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return mHeader->writerPid.load() != 0 && memcmp(&mHeader->writerGuid, &guid, sizeof(dds_guid_t)) == 0;
+    }
+
+    void Write(const void* message)
+    {
+        uint32_t seq = mHeader->sequence.load(std::memory_order_relaxed);
+        mHeader->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy(mPayload, message, mMessageSize);
+
+        mHeader->sequence.store(seq + 2);
+
+        if (mHeader->waiters.load() > 0)
+        {
+            syscall(SYS_futex, (uint32_t*)&mHeader->sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        }
+    }
+
+    /*
+     * Copy the latest message out. false if no consistent copy was made.
+     */
+    bool Read(void* message, uint32_t& sequence) const
+    {
+        for (int32_t i=0; i<UT_DDS_SHM_READ_RETRY_MAX; i++)
+        {
+            uint32_t seq = mHeader->sequence.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                continue;
+            }
+
+            memcpy(message, mPayload, mMessageSize);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (seq == mHeader->sequence.load(std::memory_order_relaxed))
+            {
+                sequence = seq;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    uint32_t GetSequence() const
+    {
+        return mHeader->sequence.load(std::memory_order_acquire);
+    }
+
+    /*
+     * Wait sequence changed from the given one or timeout.
+     */
+    bool Wait(uint32_t sequence, uint64_t microsec)
+    {
+        if (mHeader->sequence.load() != sequence)
+        {
+            return true;
+        }
+
+        struct timespec ts;
+        MicrosecondToTimespec(microsec, ts);
+
+        mHeader->waiters.fetch_add(1);
+        syscall(SYS_futex, (uint32_t*)&mHeader->sequence, FUTEX_WAIT, sequence, &ts, NULL, 0);
+        mHeader->waiters.fetch_sub(1);
+
+        return mHeader->sequence.load() != sequence;
+    }
+
+private:
+    /*
+     * 1 opened, 0 failed, -1 to open again.
+     */
+    int32_t TryOpen()
+    {
+        mFd = shm_open(mName.c_str(), O_CREAT | O_RDWR, 0666);
+        if (mFd < 0)
+        {
+            return 0;
+        }
+
+        //blocked while another process initializes segment
+        struct stat st;
+        if (flock(mFd, LOCK_SH) < 0 || fstat(mFd, &st) < 0)
+        {
+            CloseFd();
+            return 0;
+        }
+
+        //unlinked by its last user after we opened the name
+        if (st.st_nlink == 0)
+        {
+            CloseFd();
+            return -1;
+        }
+
+        if ((uint64_t)st.st_size == mSize && Map())
+        {
+            if (IsValid())
+            {
+                return 1;
+            }
+
+            Unmap();
+        }
+
+        /*
+         * new, stale or of another layout, initialized only by a sole user.
+         * a segment in use by others as another message type is an error.
+         */
+        if (flock(mFd, LOCK_EX | LOCK_NB) < 0)
+        {
+            bool inUse = (uint64_t)st.st_size == mSize;
+            CloseFd();
+            return inUse ? 0 : -1;
+        }
+
+        if (ftruncate(mFd, 0) < 0 || ftruncate(mFd, mSize) < 0 || !Map())
+        {
+            CloseFd();
+            return 0;
+        }
+
+        mHeader->version = UT_DDS_SHM_VERSION;
+        mHeader->messageSize = mMessageSize;
+        mHeader->typeHash = mTypeHash;
+        mHeader->magic.store(UT_DDS_SHM_MAGIC, std::memory_order_release);
+
+        flock(mFd, LOCK_SH);
+
+        return 1;
+    }
+
+    bool Map()
+    {
+        void* addr = mmap(NULL, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+        if (addr == MAP_FAILED)
+        {
+            return false;
+        }
+
+        mHeader = (DdsShmHeader*)addr;
+        mPayload = (uint8_t*)addr + PayloadOffset();
+
+        return true;
+    }
+
+    void Unmap()
+    {
+        munmap((void*)mHeader, mSize);
+        mHeader = NULL;
+        mPayload = NULL;
+    }
+
+    void CloseFd()
+    {
+        close(mFd);
+        mFd = -1;
+    }
+
+    bool IsValid() const
+    {
+        return mHeader->magic.load(std::memory_order_acquire) == UT_DDS_SHM_MAGIC &&
+            mHeader->version == UT_DDS_SHM_VERSION &&
+            mHeader->messageSize == mMessageSize &&
+            mHeader->typeHash == mTypeHash;
+    }
+
+    static uint64_t PayloadOffset()
+    {
+        return (sizeof(DdsShmHeader) + 63) & ~((uint64_t)63);
+    }
+
+    static bool IsProcessAlive(int32_t pid)
+    {
+        return kill(pid, 0) == 0 || errno != ESRCH;
+    }
+
+private:
+    std::string mName;
+    int32_t mFd;
+    uint64_t mSize;
+    uint64_t mMessageSize;
+    uint64_t mTypeHash;
+    DdsShmHeader* mHeader;
+    uint8_t* mPayload;
+    bool mWriter;
+    int32_t mReaderSlot;
+};
+
+using DdsShmSegmentPtr = std::shared_ptr<DdsShmSegment>;
+
+template<typename MSG>
+static inline DdsShmSegmentPtr DdsShmCreateSegment(uint32_t domainId, const std::string& topic)
+{
+    static_assert(DdsIsFixedSize(MSG), "shared memory transport requires fixed size message");
+
+    DdsShmSegmentPtr segmentPtr(new DdsShmSegment(DdsShmSegment::MakeName(domainId, topic), sizeof(MSG),
+        DdsShmSegment::MakeTypeHash(DdsGetTypeName(MSG), sizeof(MSG))));
+
+    if (!segmentPtr->Open())
+    {
+        segmentPtr.reset();
+    }
+
+    return segmentPtr;
+}
+
+/*
+ * @brief: DdsShmWriter
+ */
+template<typename MSG>
+class DdsShmWriter
+{
+public:
+    explicit DdsShmWriter(const DdsShmSegmentPtr& segmentPtr) :
+        mSegmentPtr(segmentPtr)
+    {}
+
+    void Write(const MSG& message)
+    {
+        mSegmentPtr->Write((const void*)&message);
+    }
+
+    uint32_t GetLiveReaderCount(int32_t excludePid = 0) const
+    {
+        return mSegmentPtr->GetLiveReaderCount(excludePid);
+    }
+
+    bool IsReader(const dds_guid_t& guid) const
+    {
+        return mSegmentPtr->IsReader(guid);
+    }
+
+    uint32_t GetReaderGeneration() const
+    {
+        return mSegmentPtr->GetReaderGeneration();
+    }
+
+private:
+    DdsShmSegmentPtr mSegmentPtr;
+};
+
+template<typename MSG>
+using DdsShmWriterPtr = std::shared_ptr<DdsShmWriter<MSG>>;
+
+/*
+ * @brief: DdsShmReader
+ *         Deliver the latest message of segment to handler on own thread.
+ *         Messages written faster than delivered are overwritten.
+ */
+template<typename MSG>
+class DdsShmReader
+{
+public:
+    explicit DdsShmReader(const DdsShmSegmentPtr& segmentPtr, const std::function<void(const MSG&)>& handler) :
+        mQuit(false), mSegmentPtr(segmentPtr), mHandler(handler)
+    {
+        mThreadPtr = CreateThreadEx("shmrd", UT_CPU_ID_NONE, &DdsShmReader::ThreadFunction, this);
+    }
+
+    ~DdsShmReader()
+    {
+        mQuit = true;
+        mThreadPtr->Wait();
+    }
+
+    const DdsShmSegmentPtr& GetSegment() const
+    {
+        return mSegmentPtr;
+    }
+
+private:
+    int32_t ThreadFunction()
+    {
+        MSG_PTR dataPtr(new MSG());
+        uint32_t lastSequence = mSegmentPtr->GetSequence();
+
+        while (!mQuit)
+        {
+            mSegmentPtr->Heartbeat();
+
+            if (!mSegmentPtr->Wait(lastSequence, UT_DDS_SHM_WAIT_TIME_SLICE))
+            {
+                continue;
+            }
+
+            uint32_t sequence = 0;
+            if (!mSegmentPtr->Read((void*)dataPtr.get(), sequence))
+            {
+                //writer is still writing, wait next sequence
+                lastSequence = mSegmentPtr->GetSequence();
+            }
+            else if (sequence != lastSequence)
+            {
+                lastSequence = sequence;
+                mHandler(*dataPtr);
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    using MSG_PTR = std::shared_ptr<MSG>;
+
+    volatile bool mQuit;
+    DdsShmSegmentPtr mSegmentPtr;
+    std::function<void(const MSG&)> mHandler;
+    ThreadPtr mThreadPtr;
+};
+
+template<typename MSG>
+using DdsShmReaderPtr = std::shared_ptr<DdsShmReader<MSG>>;
+
+}
+}
+
+#endif//__UT_DDS_SHM_TRANSPORT_HPP__
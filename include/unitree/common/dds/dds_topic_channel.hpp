@@ -2,6 +2,9 @@
 #define __UT_DDS_TOPIC_CHANNEL_HPP__
 
 #include <unitree/common/dds/dds_entity.hpp>
+#include <unitree/common/dds/dds_shm_transport.hpp>
+#include <unitree/common/dds/dds_intra_process.hpp>
+#include <unitree/common/dds/dds_qos_profile.hpp>
 
 namespace unitree
 {
@@ -28,27 +31,132 @@ template<typename MSG>
 class DdsTopicChannel : public DdsTopicChannelAbstract
 {
 public:
-    explicit DdsTopicChannel()
+    explicit DdsTopicChannel() :
+        mDomainId(0), mShmTransport(false), mIntraProcess(false), mWriteBatch(false), mRemoteReader(true),
+        mRemoteReaderGeneration(0)
     {}
 
     ~DdsTopicChannel()
-    {}
+    {
+        if (mIntraTopic)
+        {
+            if (mReader)
+            {
+                mIntraTopic->RemoveReader(mReader);
+            }
+
+            if (mWriter)
+            {
+                mIntraTopic->RemoveWriter(mIntraWriterGuid);
+            }
+        }
+    }
+
+    /*
+     * Qos profile of topic applied over the qos given to topic, writer and
+     * reader. Must be set before topic.
+     */
+    void SetQosProfile(const DdsQosProfilePtr& profilePtr)
+    {
+        mQosProfilePtr = profilePtr;
+    }
 
     void SetTopic(const DdsParticipantPtr& participant, const std::string& name, const DdsTopicQos& qos)
     {
-        mTopic = DdsTopicPtr<MSG>(new DdsTopic<MSG>(participant, name, qos));
+        mTopic = DdsTopicPtr<MSG>(new DdsTopic<MSG>(participant, name, ApplyQosProfile(qos)));
+        mName = name;
+        mDomainId = participant->GetNative().domain_id();
+    }
+
+    /*
+     * Same-host shared memory transport for fixed size message. The segment
+     * keeps only the latest message, so only readers keeping the latest
+     * sample, KEEP_LAST(1) without queue, read it; other readers of the host
+     * get every sample by dds. Must be set before writer and reader.
+     */
+    void SetShmTransport(bool enable)
+    {
+        mShmTransport = enable && DdsIsFixedSize(MSG);
+    }
+
+    /*
+     * Intra-process delivery to readers of the same topic in this process.
+     * Message is delivered on writer's thread, directly to reader handler if
+     * reader has no queue. Must be set before writer and reader.
+     */
+    void SetIntraProcess(bool enable)
+    {
+        mIntraProcess = enable;
+    }
+
+    /*
+     * Batch capable writer, flushed by DdsWriteBatch. Must be set before writer.
+     */
+    void SetWriteBatch(bool enable)
+    {
+        mWriteBatch = enable;
+    }
+
+    /*
+     * Executor class dispatching reader callbacks, empty for default.
+     * Must be set before reader.
+     */
+    void SetExecutorClass(const std::string& name)
+    {
+        mExecutorClass = name;
     }
 
     void SetWriter(const DdsPublisherPtr& publisher, const DdsWriterQos& qos)
     {
-        mWriter = DdsWriterPtr<MSG>(new DdsWriter<MSG>(publisher, mTopic, qos));
-        MicroSleep(UT_DDS_WAIT_MATCHED_TIME_MICRO_SEC);
+        mWriter = DdsWriterPtr<MSG>(new DdsWriter<MSG>(publisher, mTopic, ApplyQosProfile(qos), mWriteBatch));
+        SetShmWriter();
+        SetIntraProcessWriter();
     }
 
     void SetReader(const DdsSubscriberPtr& subscriber, const DdsReaderQos& qos, const DdsReaderCallback& cb, int32_t queuelen)
     {
-        mReader = DdsReaderPtr<MSG>(new DdsReader<MSG>(subscriber, mTopic, qos));
+        mReader = DdsReaderPtr<MSG>(new DdsReader<MSG>(subscriber, mTopic, ApplyQosProfile(qos)));
+        PrepareReader(queuelen);
+        mReader->SetExecutorClass(mExecutorClass);
         mReader->SetListener(cb, queuelen);
+        StartReader();
+    }
+
+    void SetReader(const DdsSubscriberPtr& subscriber, const DdsReaderQos& qos, const DdsTypedMessageHandler<MSG>& handler, int32_t queuelen)
+    {
+        mReader = DdsReaderPtr<MSG>(new DdsReader<MSG>(subscriber, mTopic, ApplyQosProfile(qos)));
+        PrepareReader(queuelen);
+        mReader->SetExecutorClass(mExecutorClass);
+        mReader->SetListener(handler, queuelen);
+        StartReader();
+    }
+
+    void SetReader(const DdsSubscriberPtr& subscriber, const DdsReaderQos& qos, const DdsLoanedMessageHandler<MSG>& handler)
+    {
+        mReader = DdsReaderPtr<MSG>(new DdsReader<MSG>(subscriber, mTopic, ApplyQosProfile(qos)));
+        mReader->SetListener(handler);
+    }
+
+    /*
+     * Polling reader without listener, keeps only the latest sample. It is
+     * not served by shm or intra-process delivery.
+     */
+    void SetPollingReader(const DdsSubscriberPtr& subscriber, const DdsReaderQos& qos)
+    {
+        mReader = DdsReaderPtr<MSG>(new DdsReader<MSG>(subscriber, mTopic, ApplyQosProfile(qos), true));
+    }
+
+    /*
+     * Wait until count readers are matched, intra-process readers included.
+     */
+    bool WaitMatched(int32_t count, int64_t waitMicrosec)
+    {
+        if (!mWriter)
+        {
+            return false;
+        }
+
+        return mWriter->WaitMatched(count, waitMicrosec);
     }
 
     DdsWriterPtr<MSG> GetWriter() const
@@ -68,6 +176,27 @@ public:
 
     bool Write(const MSG& message, int64_t waitMicrosec)
     {
+        bool delivered = false;
+
+        if (mIntraTopic)
+        {
+            delivered = mIntraTopic->Deliver(message) > 0;
+        }
+
+        if (mShmWriter)
+        {
+            mShmWriter->Write(message);
+            delivered = delivered || mShmWriter->GetLiveReaderCount() > 0;
+        }
+
+        /*
+         * skip dds write if all matched readers are intra-process or same-host shm readers.
+         */
+        if (delivered && !HasRemoteReader())
+        {
+            return true;
+        }
+
         return mWriter->Write(message, waitMicrosec);
     }
 
@@ -81,15 +210,253 @@ public:
         return 0;
     }
 
+    uint64_t GetEvictedCount() const
+    {
+        if (mReader)
+        {
+            return mReader->GetEvictedCount();
+        }
+
+        return 0;
+    }
+
+private:
+    /*
+     * Whether a matched dds reader is not served by intra-process or shm.
+     * The verdict is kept until a dds reader is matched or unmatched, or a
+     * local reader is added or removed. Matched readers are told by guid.
+     */
+    bool HasRemoteReader()
+    {
+        uint64_t generation = GetReaderGeneration();
+        if (generation == mRemoteReaderGeneration.load(std::memory_order_acquire))
+        {
+            return mRemoteReader.load(std::memory_order_relaxed);
+        }
+
+        LockGuard<Mutex> guard(mRemoteReaderMutex);
+
+        //taken before readers are looked at, a change meanwhile moves it again
+        generation = GetReaderGeneration();
+
+        bool remote = true;
+        if (mWriter->GetMatchedReaders(mMatchedReaders))
+        {
+            remote = false;
+
+            for (dds_instance_handle_t handle : mMatchedReaders)
+            {
+                dds_guid_t guid;
+                if (!mWriter->GetMatchedReaderGuid(handle, guid) ||
+                    !((mIntraTopic && mIntraTopic->IsReader(guid)) || (mShmWriter && mShmWriter->IsReader(guid))))
+                {
+                    remote = true;
+                    break;
+                }
+            }
+        }
+
+        mRemoteReader.store(remote, std::memory_order_relaxed);
+        mRemoteReaderGeneration.store(generation, std::memory_order_release);
+
+        return remote;
+    }
+
+    uint64_t GetReaderGeneration() const
+    {
+        //never 0, the generation of no verdict
+        return 1 + (uint64_t)mWriter->GetMatchedGeneration() +
+            (mIntraTopic ? mIntraTopic->GetReaderGeneration() : 0) +
+            (mShmWriter ? mShmWriter->GetReaderGeneration() : 0);
+    }
+
+    template<typename QOS>
+    QOS ApplyQosProfile(const QOS& qos) const
+    {
+        QOS profileQos = qos;
+        if (mQosProfilePtr)
+        {
+            mQosProfilePtr->Apply(profileQos);
+        }
+
+        return profileQos;
+    }
+
+    void SetShmWriter()
+    {
+        if constexpr (DdsIsFixedSize(MSG))
+        {
+            dds_guid_t guid;
+            if (!mShmTransport || !mWriter->GetGuid(guid))
+            {
+                return;
+            }
+
+            DdsShmSegmentPtr segmentPtr = DdsShmCreateSegment<MSG>(mDomainId, mName);
+            if (segmentPtr && segmentPtr->ClaimWriter(guid))
+            {
+                mShmWriter = DdsShmWriterPtr<MSG>(new DdsShmWriter<MSG>(segmentPtr));
+            }
+        }
+    }
+
+    void SetIntraProcessWriter()
+    {
+        if (!mIntraProcess || !mWriter->GetGuid(mIntraWriterGuid))
+        {
+            return;
+        }
+
+        mIntraTopic = DdsIntraProcessRegistry<MSG>::Instance()->GetTopic(mDomainId, mName);
+        mIntraTopic->AddWriter(mIntraWriterGuid);
+    }
+
+    void PrepareReader(int32_t queuelen)
+    {
+        if constexpr (DdsIsFixedSize(MSG))
+        {
+            //a queue would only be fed the latest message of the segment
+            if (mShmTransport && queuelen <= 0 && mExecutorClass.empty() && mReader->IsKeepLatest())
+            {
+                dds_guid_t guid;
+                if (mReader->GetGuid(guid))
+                {
+                    mShmSegmentPtr = DdsShmCreateSegment<MSG>(mDomainId, mName);
+                }
+
+                if (mShmSegmentPtr && !mShmSegmentPtr->AttachReader(guid))
+                {
+                    mShmSegmentPtr.reset();
+                }
+            }
+        }
+
+        if (mIntraProcess)
+        {
+            mIntraTopic = DdsIntraProcessRegistry<MSG>::Instance()->GetTopic(mDomainId, mName);
+        }
+
+        if (!mShmSegmentPtr && !mIntraTopic)
+        {
+            return;
+        }
+
+        /*
+         * drop dds samples of writers already delivered by shm or intra-process.
+         */
+        DdsShmSegmentPtr segmentPtr = mShmSegmentPtr;
+        DdsIntraProcessTopicPtr<MSG> intraTopic = mIntraTopic;
+
+        mReader->SetPublicationFilter([segmentPtr, intraTopic](const dds_guid_t& guid) {
+            return (segmentPtr && segmentPtr->IsWriter(guid)) || (intraTopic && intraTopic->IsWriter(guid));
+        });
+    }
+
+    void StartReader()
+    {
+        if constexpr (DdsIsFixedSize(MSG))
+        {
+            if (mShmSegmentPtr)
+            {
+                DdsReaderPtr<MSG> reader = mReader;
+                DdsShmSegmentPtr segmentPtr = mShmSegmentPtr;
+                int32_t pid = mIntraTopic ? getpid() : 0;
+
+                mShmReader = DdsShmReaderPtr<MSG>(new DdsShmReader<MSG>(mShmSegmentPtr, [reader, segmentPtr, pid](const MSG& message) {
+                    //writer of this process delivers by intra-process
+                    if (pid == 0 || segmentPtr->GetWriterPid() != pid)
+                    {
+                        reader->Deliver(message);
+                    }
+                }));
+            }
+        }
+
+        if (mIntraTopic)
+        {
+            mIntraTopic->AddReader(mReader);
+        }
+    }
+
 private:
+    std::string mName;
+    uint32_t mDomainId;
+    bool mShmTransport;
+    bool mIntraProcess;
+    bool mWriteBatch;
+    std::string mExecutorClass;
+    DdsQosProfilePtr mQosProfilePtr;
+
     DdsTopicPtr<MSG> mTopic;
     DdsWriterPtr<MSG> mWriter;
     DdsReaderPtr<MSG> mReader;
+
+    DdsShmWriterPtr<MSG> mShmWriter;
+    DdsShmSegmentPtr mShmSegmentPtr;
+    DdsShmReaderPtr<MSG> mShmReader;
+
+    DdsIntraProcessTopicPtr<MSG> mIntraTopic;
+    dds_guid_t mIntraWriterGuid;
+
+    Mutex mRemoteReaderMutex;
+    std::atomic<bool> mRemoteReader;
+    std::atomic<uint64_t> mRemoteReaderGeneration;
+    std::vector<dds_instance_handle_t> mMatchedReaders;
 };
 
 template<typename MSG>
 using DdsTopicChannelPtr = std::shared_ptr<DdsTopicChannel<MSG>>;
 
+/*
+ * @brief: DdsTopicHandle
+ *         Typed handle of a registered topic channel, writes go straight to
+ *         the channel without topic name lookup.
+ */
+template<typename MSG>
+class DdsTopicHandle
+{
+public:
+    explicit DdsTopicHandle()
+    {}
+
+    explicit DdsTopicHandle(const DdsTopicChannelPtr<MSG>& channelPtr) :
+        mChannelPtr(channelPtr)
+    {}
+
+    bool Valid() const
+    {
+        return mChannelPtr != NULL;
+    }
+
+    bool Write(const MSG& message, int64_t waitMicrosec = 0) const
+    {
+        if (mChannelPtr)
+        {
+            return mChannelPtr->Write(message, waitMicrosec);
+        }
+
+        return false;
+    }
+
+    int64_t GetLastDataAvailableTime() const
+    {
+        if (mChannelPtr)
+        {
+            return mChannelPtr->GetLastDataAvailableTime();
+        }
+
+        return 0;
+    }
+
+    const DdsTopicChannelPtr<MSG>& GetChannel() const
+    {
+        return mChannelPtr;
+    }
+
+private:
+    DdsTopicChannelPtr<MSG> mChannelPtr;
+};
+
 }
 }
 
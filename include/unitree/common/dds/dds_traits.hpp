@@ -13,6 +13,9 @@ namespace common
 #define DdsIsKeyless(TYPE) \
     org::eclipse::cyclonedds::topic::TopicTraits<TYPE>::isKeyless()
 
+#define DdsIsFixedSize(TYPE) \
+    std::is_trivially_copyable<TYPE>::value
+
 }
 }
 #endif//__UT_DDS_TRAINTS_HPP__
@@ -0,0 +1,856 @@
+#ifndef __UT_JSON_READER_HPP__
+#define __UT_JSON_READER_HPP__
+
+#include <list>
+#include <set>
+#include <charconv>
+#include <limits>
+#include <cstring>
+#include <unitree/common/exception.hpp>
+#include <unitree/common/json/json.hpp>
+
+/*
+ * deepest nesting of arrays and objects accepted by JsonReader.
+ */
+#define UT_JSON_READER_MAX_DEPTH    128
+
+/*
+ * Register fields of a class for json, at namespace scope of the class:
+ *
+ * struct MoveParameter
+ * {
+ *     float vx;
+ *     float vy;
+ *     float vyaw;
+ * };
+ *
+ * UT_JSONIZE(MoveParameter, vx, vy, vyaw)
+ *
+ * Fields are public and named in json as in the class, up to 32 fields.
+ * FromJsonString parses registered classes straight into their fields by
+ * JsonReader, FromJson/ToJson by Any work on them as on Jsonize classes.
+ */
+#define UT_JSONIZE(Type, ...)                                           \
+    template<typename V>                                                \
+    void UtJsonizeFields(V& visitor, Type& t)                           \
+    {                                                                   \
+        UT_JSONIZE_FOR_EACH(UT_JSONIZE_FIELD, __VA_ARGS__)              \
+    }                                                                   \
+    template<typename V>                                                \
+    void UtJsonizeFields(V& visitor, const Type& t)                     \
+    {                                                                   \
+        UT_JSONIZE_FOR_EACH(UT_JSONIZE_FIELD, __VA_ARGS__)              \
+    }
+
+#define UT_JSONIZE_FIELD(field) visitor(#field, t.field);
+
+#define UT_JSONIZE_EXPAND(x) x
+#define UT_JSONIZE_SELECT(_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,_32, NAME, ...) NAME
+#define UT_JSONIZE_FOR_EACH(F, ...) \
+    UT_JSONIZE_EXPAND(UT_JSONIZE_SELECT(__VA_ARGS__, UT_JSONIZE_FE_32, UT_JSONIZE_FE_31, UT_JSONIZE_FE_30, UT_JSONIZE_FE_29, UT_JSONIZE_FE_28, UT_JSONIZE_FE_27, UT_JSONIZE_FE_26, UT_JSONIZE_FE_25, UT_JSONIZE_FE_24, UT_JSONIZE_FE_23, UT_JSONIZE_FE_22, UT_JSONIZE_FE_21, UT_JSONIZE_FE_20, UT_JSONIZE_FE_19, UT_JSONIZE_FE_18, UT_JSONIZE_FE_17, UT_JSONIZE_FE_16, UT_JSONIZE_FE_15, UT_JSONIZE_FE_14, UT_JSONIZE_FE_13, UT_JSONIZE_FE_12, UT_JSONIZE_FE_11, UT_JSONIZE_FE_10, UT_JSONIZE_FE_9, UT_JSONIZE_FE_8, UT_JSONIZE_FE_7, UT_JSONIZE_FE_6, UT_JSONIZE_FE_5, UT_JSONIZE_FE_4, UT_JSONIZE_FE_3, UT_JSONIZE_FE_2, UT_JSONIZE_FE_1)(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_1(F, x) F(x)
+#define UT_JSONIZE_FE_2(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_1(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_3(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_2(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_4(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_3(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_5(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_4(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_6(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_5(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_7(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_6(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_8(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_7(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_9(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_8(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_10(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_9(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_11(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_10(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_12(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_11(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_13(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_12(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_14(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_13(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_15(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_14(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_16(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_15(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_17(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_16(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_18(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_17(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_19(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_18(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_20(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_19(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_21(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_20(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_22(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_21(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_23(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_22(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_24(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_23(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_25(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_24(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_26(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_25(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_27(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_26(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_28(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_27(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_29(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_28(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_30(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_29(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_31(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_30(F, __VA_ARGS__))
+#define UT_JSONIZE_FE_32(F, x, ...) F(x) UT_JSONIZE_EXPAND(UT_JSONIZE_FE_31(F, __VA_ARGS__))
+
+namespace unitree
+{
+namespace common
+{
+template<typename T>
+void FromJson(const Any& a, T& t);
+
+struct JsonizeFieldsProbe
+{
+    template<typename F>
+    void operator()(const char*, F&)
+    {}
+};
+
+/*
+ * Class registered by UT_JSONIZE.
+ */
+template<typename T, typename = void>
+struct IsJsonizeFields : std::false_type
+{};
+
+template<typename T>
+struct IsJsonizeFields<T, decltype(UtJsonizeFields(std::declval<JsonizeFieldsProbe&>(), std::declval<T&>()))> : std::true_type
+{};
+
+/*
+ * Class registered by UT_JSONIZE, or container of them, parsed by
+ * JsonReader in FromJsonString.
+ */
+template<typename T>
+struct IsJsonReaderType : IsJsonizeFields<T>
+{};
+
+template<typename E>
+struct IsJsonReaderType<std::vector<E>> : IsJsonReaderType<E>
+{};
+
+template<typename E>
+struct IsJsonReaderType<std::list<E>> : IsJsonReaderType<E>
+{};
+
+template<typename E>
+struct IsJsonReaderType<std::set<E>> : IsJsonReaderType<E>
+{};
+
+template<typename E>
+struct IsJsonReaderType<std::map<std::string,E>> : IsJsonReaderType<E>
+{};
+
+/*
+ * @brief: JsonReader
+ *         Pull parser writing json text straight into values: arithmetic,
+ *         string, vector, list, set, map of string key and classes by
+ *         UT_JSONIZE, without a tree of Any. Unknown members are skipped and
+ *         null leaves value as it is. Any, JsonMap and JsonArray are read as
+ *         a tree. Other types are parsed to Any by the library and set by
+ *         FromJson. Throws JsonException on malformed text.
+ */
+class JsonReader
+{
+public:
+    JsonReader(const char* data, size_t size) :
+        mBegin(data), mPos(data), mEnd(data + size), mDepth(0), mKey(NULL), mKeyLen(0)
+    {}
+
+    template<typename T>
+    void Parse(T& t)
+    {
+        Read(t);
+
+        SkipSpace();
+        if (mPos != mEnd)
+        {
+            Error("unexpected text after value");
+        }
+    }
+
+    void Read(bool& value)
+    {
+        if (ReadNull())
+        {
+            return;
+        }
+
+        if (ReadLiteral("true"))
+        {
+            value = true;
+        }
+        else if (ReadLiteral("false"))
+        {
+            value = false;
+        }
+        else
+        {
+            Error("bool expected");
+        }
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type Read(T& value)
+    {
+        if (ReadNull())
+        {
+            return;
+        }
+
+        const char* begin = mPos;
+        bool integral = true;
+
+        if (mPos < mEnd && *mPos == '-')
+        {
+            mPos++;
+        }
+
+        while (mPos < mEnd)
+        {
+            char c = *mPos;
+            if (c >= '0' && c <= '9')
+            {
+                mPos++;
+            }
+            else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+            {
+                integral = false;
+                mPos++;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        size_t len = mPos - begin;
+        if (len == 0 || len >= 64)
+        {
+            Error("number expected");
+        }
+
+        if constexpr (std::is_integral<T>::value)
+        {
+            if (integral)
+            {
+                std::from_chars_result result = std::from_chars(begin, mPos, value);
+                if (result.ec != std::errc() || result.ptr != mPos)
+                {
+                    Error("integer out of range");
+                }
+
+                return;
+            }
+        }
+
+        //strtod needs terminated text
+        char buf[64];
+        memcpy(buf, begin, len);
+        buf[len] = 0;
+
+        char* end = NULL;
+        double d = strtod(buf, &end);
+        if (end != buf + len)
+        {
+            Error("bad number");
+        }
+
+        if constexpr (std::is_integral<T>::value)
+        {
+            //bounds are powers of two, exact in double; NaN fails both
+            const double lower = (double)std::numeric_limits<T>::min();
+            const double upper = (double)(std::numeric_limits<T>::max() / 2 + 1) * 2.0;
+
+            if (!(d >= lower && d < upper))
+            {
+                Error("integer out of range");
+            }
+        }
+
+        value = (T)d;
+    }
+
+    void Read(std::string& value)
+    {
+        if (ReadNull())
+        {
+            return;
+        }
+
+        value.clear();
+        ReadString(value);
+    }
+
+    template<typename E>
+    void Read(std::vector<E>& value)
+    {
+        ReadArray([this, &value]() {
+            value.emplace_back();
+            Read(value.back());
+        });
+    }
+
+    template<typename E>
+    void Read(std::list<E>& value)
+    {
+        ReadArray([this, &value]() {
+            value.emplace_back();
+            Read(value.back());
+        });
+    }
+
+    template<typename E>
+    void Read(std::set<E>& value)
+    {
+        ReadArray([this, &value]() {
+            E e;
+            Read(e);
+            value.insert(std::move(e));
+        });
+    }
+
+    template<typename E>
+    void Read(std::map<std::string,E>& value)
+    {
+        std::string key;
+        ReadObject([this, &value, &key]() {
+            key.clear();
+            ReadString(key);
+            Expect(':');
+            Read(value[key]);
+        });
+    }
+
+    /*
+     * Tree of Any as the library parser builds: JsonMap, JsonArray, string,
+     * bool, int64_t (uint64_t if larger), double, and empty Any for null.
+     */
+    void Read(Any& value)
+    {
+        char c = Peek();
+
+        if (c == '{')
+        {
+            JsonMap json;
+            Read(json);
+            value = std::move(json);
+        }
+        else if (c == '[')
+        {
+            JsonArray json;
+            Read(json);
+            value = std::move(json);
+        }
+        else if (c == '"')
+        {
+            std::string s;
+            ReadString(s);
+            value = std::move(s);
+        }
+        else if (c == 't' || c == 'f')
+        {
+            bool b = false;
+            Read(b);
+            value = b;
+        }
+        else if (ReadNull())
+        {
+            value = Any();
+        }
+        else
+        {
+            ReadNumber(value);
+        }
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value>::type Read(T& value)
+    {
+        if constexpr (IsJsonizeFields<T>::value)
+        {
+            if (ReadNull())
+            {
+                return;
+            }
+
+            ReadObject([this, &value]() {
+                ReadKey();
+                Expect(':');
+
+                FieldReader fieldReader(*this);
+                UtJsonizeFields(fieldReader, value);
+
+                if (!fieldReader.mFound)
+                {
+                    SkipValue();
+                }
+            });
+        }
+        else
+        {
+            /*
+             * Jsonize, JsonMap, Any and others keep the tree way.
+             */
+            const char* begin = SkipValue();
+            FromJson(FromJsonString(std::string(begin, mPos - begin)), value);
+        }
+    }
+
+private:
+    struct FieldReader
+    {
+        explicit FieldReader(JsonReader& reader) :
+            mReader(reader), mFound(false)
+        {}
+
+        template<typename F>
+        void operator()(const char* name, F& field)
+        {
+            if (!mFound && mReader.IsKey(name))
+            {
+                mFound = true;
+                mReader.Read(field);
+            }
+        }
+
+        JsonReader& mReader;
+        bool mFound;
+    };
+
+    void Error(const char* message)
+    {
+        UT_THROW(JsonException, std::string("json ") + message + " at offset " + std::to_string(mPos - mBegin));
+    }
+
+    void SkipSpace()
+    {
+        while (mPos < mEnd && (*mPos == ' ' || *mPos == '\t' || *mPos == '\n' || *mPos == '\r'))
+        {
+            mPos++;
+        }
+    }
+
+    char Peek()
+    {
+        SkipSpace();
+        if (mPos == mEnd)
+        {
+            Error("unexpected end");
+        }
+
+        return *mPos;
+    }
+
+    void Expect(char c)
+    {
+        if (Peek() != c)
+        {
+            Error("unexpected character");
+        }
+
+        mPos++;
+    }
+
+    bool ReadLiteral(const char* literal)
+    {
+        size_t len = strlen(literal);
+        if ((size_t)(mEnd - mPos) >= len && memcmp(mPos, literal, len) == 0)
+        {
+            mPos += len;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ReadNull()
+    {
+        Peek();
+        return ReadLiteral("null");
+    }
+
+    template<typename F>
+    void ReadArray(const F& readElement)
+    {
+        if (ReadNull())
+        {
+            return;
+        }
+
+        Expect('[');
+        Enter();
+
+        if (Peek() == ']')
+        {
+            mPos++;
+            mDepth--;
+            return;
+        }
+
+        while (true)
+        {
+            readElement();
+
+            char c = Peek();
+            mPos++;
+
+            if (c == ']')
+            {
+                break;
+            }
+            else if (c != ',')
+            {
+                Error("',' or ']' expected");
+            }
+        }
+
+        mDepth--;
+    }
+
+    template<typename F>
+    void ReadObject(const F& readMember)
+    {
+        if (ReadNull())
+        {
+            return;
+        }
+
+        Expect('{');
+        Enter();
+
+        if (Peek() == '}')
+        {
+            mPos++;
+            mDepth--;
+            return;
+        }
+
+        while (true)
+        {
+            readMember();
+
+            char c = Peek();
+            mPos++;
+
+            if (c == '}')
+            {
+                break;
+            }
+            else if (c != ',')
+            {
+                Error("',' or '}' expected");
+            }
+        }
+
+        mDepth--;
+    }
+
+    void ReadNumber(Any& value)
+    {
+        const char* begin = mPos;
+        const char* p = (mPos < mEnd && *mPos == '-') ? mPos + 1 : mPos;
+
+        while (p < mEnd && *p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+
+        if (p < mEnd && (*p == '.' || *p == 'e' || *p == 'E'))
+        {
+            double d = 0;
+            Read(d);
+            value = d;
+        }
+        else if (*begin == '-')
+        {
+            int64_t i = 0;
+            Read(i);
+            value = i;
+        }
+        else
+        {
+            uint64_t u = 0;
+            Read(u);
+            if (u <= (uint64_t)std::numeric_limits<int64_t>::max())
+            {
+                value = (int64_t)u;
+            }
+            else
+            {
+                value = u;
+            }
+        }
+    }
+
+    void Enter()
+    {
+        if (++mDepth > UT_JSON_READER_MAX_DEPTH)
+        {
+            Error("nesting too deep");
+        }
+    }
+
+    /*
+     * Key of member, kept in text if it has no escape.
+     */
+    void ReadKey()
+    {
+        if (Peek() != '"')
+        {
+            Error("key expected");
+        }
+
+        const char* begin = ++mPos;
+        while (mPos < mEnd && *mPos != '"' && *mPos != '\\')
+        {
+            mPos++;
+        }
+
+        if (mPos < mEnd && *mPos == '"')
+        {
+            mKey = begin;
+            mKeyLen = mPos - begin;
+            mPos++;
+            return;
+        }
+
+        mPos = begin - 1;
+        mKeyBuffer.clear();
+        ReadString(mKeyBuffer);
+
+        mKey = mKeyBuffer.data();
+        mKeyLen = mKeyBuffer.size();
+    }
+
+    bool IsKey(const char* name) const
+    {
+        return strncmp(name, mKey, mKeyLen) == 0 && name[mKeyLen] == 0;
+    }
+
+    void ReadString(std::string& value)
+    {
+        Expect('"');
+
+        while (true)
+        {
+            const char* begin = mPos;
+            while (mPos < mEnd && *mPos != '"' && *mPos != '\\')
+            {
+                mPos++;
+            }
+
+            value.append(begin, mPos - begin);
+
+            if (mPos == mEnd)
+            {
+                Error("unterminated string");
+            }
+
+            if (*mPos++ == '"')
+            {
+                return;
+            }
+
+            if (mPos == mEnd)
+            {
+                Error("unterminated string");
+            }
+
+            char c = *mPos++;
+            switch (c)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                value.push_back(c);
+                break;
+            case 'b':
+                value.push_back('\b');
+                break;
+            case 'f':
+                value.push_back('\f');
+                break;
+            case 'n':
+                value.push_back('\n');
+                break;
+            case 'r':
+                value.push_back('\r');
+                break;
+            case 't':
+                value.push_back('\t');
+                break;
+            case 'u':
+                AppendUtf8(value, ReadCodePoint());
+                break;
+            default:
+                Error("bad escape");
+            }
+        }
+    }
+
+    uint32_t ReadHex4()
+    {
+        if (mEnd - mPos < 4)
+        {
+            Error("bad unicode escape");
+        }
+
+        uint32_t code = 0;
+        for (int i=0; i<4; i++)
+        {
+            char c = *mPos++;
+            code <<= 4;
+
+            if (c >= '0' && c <= '9')
+            {
+                code |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                code |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                code |= c - 'A' + 10;
+            }
+            else
+            {
+                Error("bad unicode escape");
+            }
+        }
+
+        return code;
+    }
+
+    uint32_t ReadCodePoint()
+    {
+        uint32_t code = ReadHex4();
+
+        if (code >= 0xD800 && code <= 0xDBFF && mEnd - mPos >= 6 && mPos[0] == '\\' && mPos[1] == 'u')
+        {
+            const char* pos = mPos;
+            mPos += 2;
+
+            uint32_t low = ReadHex4();
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                return 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            mPos = pos;
+        }
+
+        return code;
+    }
+
+    static void AppendUtf8(std::string& value, uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            value.push_back((char)code);
+        }
+        else if (code < 0x800)
+        {
+            value.push_back((char)(0xC0 | (code >> 6)));
+            value.push_back((char)(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            value.push_back((char)(0xE0 | (code >> 12)));
+            value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+            value.push_back((char)(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            value.push_back((char)(0xF0 | (code >> 18)));
+            value.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+            value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+            value.push_back((char)(0x80 | (code & 0x3F)));
+        }
+    }
+
+    /*
+     * Skip a value, return where it begins.
+     */
+    const char* SkipValue()
+    {
+        char c = Peek();
+        const char* begin = mPos;
+
+        if (c == '"')
+        {
+            SkipString();
+        }
+        else if (c == '{' || c == '[')
+        {
+            int32_t depth = 0;
+            while (true)
+            {
+                c = Peek();
+                if (c == '"')
+                {
+                    SkipString();
+                    continue;
+                }
+
+                mPos++;
+
+                if (c == '{' || c == '[')
+                {
+                    if (++depth > UT_JSON_READER_MAX_DEPTH)
+                    {
+                        Error("nesting too deep");
+                    }
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (--depth == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            while (mPos < mEnd && *mPos != ',' && *mPos != '}' && *mPos != ']' &&
+                *mPos != ' ' && *mPos != '\t' && *mPos != '\n' && *mPos != '\r')
+            {
+                mPos++;
+            }
+
+            if (mPos == begin)
+            {
+                Error("value expected");
+            }
+        }
+
+        return begin;
+    }
+
+    void SkipString()
+    {
+        mPos++;
+        while (mPos < mEnd && *mPos != '"')
+        {
+            if (*mPos == '\\')
+            {
+                mPos++;
+            }
+
+            mPos++;
+        }
+
+        if (mPos >= mEnd)
+        {
+            Error("unterminated string");
+        }
+
+        mPos++;
+    }
+
+private:
+    const char* mBegin;
+    const char* mPos;
+    const char* mEnd;
+    int32_t mDepth;
+
+    const char* mKey;
+    size_t mKeyLen;
+    std::string mKeyBuffer;
+};
+
+}
+}
+
+#endif//__UT_JSON_READER_HPP__
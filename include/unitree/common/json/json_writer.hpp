@@ -0,0 +1,353 @@
+#ifndef __UT_JSON_WRITER_HPP__
+#define __UT_JSON_WRITER_HPP__
+
+#include <cmath>
+#include <cstdio>
+#include <unitree/common/json/json_reader.hpp>
+
+/*
+ * indent of each level in pretty output.
+ */
+#define UT_JSON_WRITER_INDENT   4
+
+namespace unitree
+{
+namespace common
+{
+class Jsonize;
+
+/*
+ * Class registered by UT_JSONIZE or derived from Jsonize, arithmetic,
+ * string, Any, or container of them (so JsonMap and JsonArray), written
+ * by JsonWriter in ToJsonString.
+ */
+template<typename T>
+struct IsJsonWriterType : std::integral_constant<bool, IsJsonizeFields<T>::value ||
+    std::is_base_of<Jsonize, T>::value || std::is_arithmetic<T>::value || std::is_same<T, std::string>::value ||
+    std::is_same<T, Any>::value>
+{};
+
+template<typename E>
+struct IsJsonWriterType<std::vector<E>> : IsJsonWriterType<E>
+{};
+
+template<typename E>
+struct IsJsonWriterType<std::list<E>> : IsJsonWriterType<E>
+{};
+
+template<typename E>
+struct IsJsonWriterType<std::set<E>> : IsJsonWriterType<E>
+{};
+
+template<typename E>
+struct IsJsonWriterType<std::map<std::string,E>> : IsJsonWriterType<E>
+{};
+
+/*
+ * @brief: JsonWriter
+ *         Writes values as json text into a buffer kept by caller, without
+ *         a tree of Any. Numbers are formatted by to_chars, floats in the
+ *         shortest text that reads back to the same value, or by snprintf
+ *         where the library has no float to_chars. Jsonize classes
+ *         are written from the JsonMap of their toJson.
+ */
+class JsonWriter
+{
+public:
+    explicit JsonWriter(std::string& buffer, bool pretty = false) :
+        mBuffer(buffer), mPretty(pretty), mDepth(0)
+    {}
+
+    void Write(bool value)
+    {
+        mBuffer.append(value ? "true" : "false");
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type Write(T value)
+    {
+        char buf[64];
+
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            if (!std::isfinite(value))
+            {
+                mBuffer.append("null");
+                return;
+            }
+        }
+
+#ifndef __cpp_lib_to_chars
+        /*
+         * float to_chars needs libstdc++ 11, older ones write floats by
+         * snprintf with digits enough to read back the same value.
+         */
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            int32_t len = snprintf(buf, sizeof(buf), sizeof(T) == sizeof(float) ? "%.9g" : "%.17g", (double)value);
+            mBuffer.append(buf, len);
+            return;
+        }
+#endif
+
+        std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value);
+        mBuffer.append(buf, result.ptr - buf);
+    }
+
+    void Write(const char* value)
+    {
+        WriteString(value, strlen(value));
+    }
+
+    void Write(const std::string& value)
+    {
+        WriteString(value.data(), value.size());
+    }
+
+    template<typename E>
+    void Write(const std::vector<E>& value)
+    {
+        WriteArray(value);
+    }
+
+    template<typename E>
+    void Write(const std::list<E>& value)
+    {
+        WriteArray(value);
+    }
+
+    template<typename E>
+    void Write(const std::set<E>& value)
+    {
+        WriteArray(value);
+    }
+
+    template<typename E>
+    void Write(const std::map<std::string,E>& value)
+    {
+        BeginObject();
+
+        bool first = true;
+        for (const auto& pair : value)
+        {
+            WriteKey(pair.first, first);
+            Write(pair.second);
+        }
+
+        EndObject(first);
+    }
+
+    void Write(const Any& value)
+    {
+        const std::type_info& type = value.GetTypeInfo();
+
+        if (value.Empty())
+        {
+            mBuffer.append("null");
+        }
+        else if (type == typeid(JsonMap))
+        {
+            Write(AnyCast<JsonMap>(value));
+        }
+        else if (type == typeid(JsonArray))
+        {
+            Write(AnyCast<JsonArray>(value));
+        }
+        else if (type == typeid(std::string))
+        {
+            Write(AnyCast<std::string>(value));
+        }
+        else if (!WriteAnyNumber<bool, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
+            int64_t, uint64_t, float, double>(value))
+        {
+            mBuffer.append(ToJsonString(value));
+        }
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value>::type Write(const T& value)
+    {
+        if constexpr (IsJsonizeFields<T>::value)
+        {
+            BeginObject();
+
+            bool first = true;
+            auto visitor = [this, &first](const char* name, const auto& field) {
+                WriteKey(name, first);
+                Write(field);
+            };
+
+            UtJsonizeFields(visitor, value);
+
+            EndObject(first);
+        }
+        else
+        {
+            static_assert(std::is_base_of<Jsonize, T>::value, "type is not writable by JsonWriter");
+
+            JsonMap json;
+            value.toJson(json);
+            Write(json);
+        }
+    }
+
+private:
+    template<typename C>
+    void WriteArray(const C& value)
+    {
+        mBuffer.push_back('[');
+        mDepth++;
+
+        bool first = true;
+        for (const auto& e : value)
+        {
+            Separate(first);
+            Write(e);
+        }
+
+        mDepth--;
+        if (!first)
+        {
+            NewLine();
+        }
+
+        mBuffer.push_back(']');
+    }
+
+    void BeginObject()
+    {
+        mBuffer.push_back('{');
+        mDepth++;
+    }
+
+    void EndObject(bool empty)
+    {
+        mDepth--;
+        if (!empty)
+        {
+            NewLine();
+        }
+
+        mBuffer.push_back('}');
+    }
+
+    void WriteKey(const std::string& key, bool& first)
+    {
+        WriteKey(key.data(), key.size(), first);
+    }
+
+    void WriteKey(const char* key, bool& first)
+    {
+        WriteKey(key, strlen(key), first);
+    }
+
+    void WriteKey(const char* key, size_t len, bool& first)
+    {
+        Separate(first);
+        WriteString(key, len);
+        mBuffer.append(mPretty ? ": " : ":");
+    }
+
+    void Separate(bool& first)
+    {
+        if (!first)
+        {
+            mBuffer.push_back(',');
+        }
+
+        first = false;
+        NewLine();
+    }
+
+    void NewLine()
+    {
+        if (mPretty)
+        {
+            mBuffer.push_back('\n');
+            mBuffer.append(mDepth * UT_JSON_WRITER_INDENT, ' ');
+        }
+    }
+
+    void WriteString(const char* s, size_t len)
+    {
+        static const char* hex = "0123456789abcdef";
+
+        mBuffer.push_back('"');
+
+        const char* begin = s;
+        const char* end = s + len;
+
+        for (const char* p = s; p < end; p++)
+        {
+            unsigned char c = (unsigned char)*p;
+            if (c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            mBuffer.append(begin, p - begin);
+            begin = p + 1;
+
+            switch (c)
+            {
+            case '"':
+                mBuffer.append("\\\"");
+                break;
+            case '\\':
+                mBuffer.append("\\\\");
+                break;
+            case '\b':
+                mBuffer.append("\\b");
+                break;
+            case '\f':
+                mBuffer.append("\\f");
+                break;
+            case '\n':
+                mBuffer.append("\\n");
+                break;
+            case '\r':
+                mBuffer.append("\\r");
+                break;
+            case '\t':
+                mBuffer.append("\\t");
+                break;
+            default:
+                mBuffer.append("\\u00");
+                mBuffer.push_back(hex[c >> 4]);
+                mBuffer.push_back(hex[c & 0xF]);
+            }
+        }
+
+        mBuffer.append(begin, end - begin);
+        mBuffer.push_back('"');
+    }
+
+    template<typename T, typename... Ts>
+    bool WriteAnyNumber(const Any& value)
+    {
+        if (value.GetTypeInfo() == typeid(T))
+        {
+            Write(AnyCast<T>(value));
+            return true;
+        }
+
+        if constexpr (sizeof...(Ts) > 0)
+        {
+            return WriteAnyNumber<Ts...>(value);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+private:
+    std::string& mBuffer;
+    bool mPretty;
+    int32_t mDepth;
+};
+
+}
+}
+
+#endif//__UT_JSON_WRITER_HPP__
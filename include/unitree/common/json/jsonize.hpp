@@ -11,6 +11,8 @@
     unitree::common::ToJson(value, m[name])
 
 #include <unitree/common/json/json.hpp>
+#include <unitree/common/json/json_reader.hpp>
+#include <unitree/common/json/json_writer.hpp>
 
 namespace unitree
 {
@@ -25,16 +27,45 @@ void ToJson(const T& value, Any& a);
 template<typename T>
 void FromJsonString(const std::string& s, T& t)
 {
-    Any a = FromJsonString(s);
-    FromJson<T>(a, t);
+    if constexpr (IsJsonReaderType<T>::value)
+    {
+        JsonReader reader(s.data(), s.size());
+        reader.Parse(t);
+    }
+    else
+    {
+        Any a = FromJsonString(s);
+        FromJson<T>(a, t);
+    }
 }
 
 template<typename T>
 std::string ToJsonString(const T& t, bool pretty = false)
 {
-    Any a;
-    ToJson<T>(t, a);
-    return ToJsonString(a, pretty);
+    if constexpr (IsJsonWriterType<T>::value)
+    {
+        std::string s;
+        JsonWriter writer(s, pretty);
+        writer.Write(t);
+        return s;
+    }
+    else
+    {
+        Any a;
+        ToJson<T>(t, a);
+        return ToJsonString(a, pretty);
+    }
+}
+
+/*
+ * Write t into s by JsonWriter, reusing capacity of s.
+ */
+template<typename T>
+void ToJsonString(const T& t, std::string& s, bool pretty = false)
+{
+    s.clear();
+    JsonWriter writer(s, pretty);
+    writer.Write(t);
 }
 
 class Jsonize
@@ -155,6 +186,27 @@ void FromAny(const Any& a, std::map<std::string,E>& value)
     }
 }
 
+template<typename T>
+typename std::enable_if<IsJsonizeFields<T>::value>::type FromAny(const Any& a, T& value)
+{
+    if (a.Empty())
+    {
+        return;
+    }
+
+    const JsonMap& m = AnyCast<JsonMap>(a);
+
+    auto visitor = [&m](const char* name, auto& field) {
+        JsonMap::const_iterator iter = m.find(name);
+        if (iter != m.end())
+        {
+            FromJson(iter->second, field);
+        }
+    };
+
+    UtJsonizeFields(visitor, value);
+}
+
 template<typename T>
 void FromJson(const Any& a, T& t)
 {
@@ -264,6 +316,19 @@ void ToAny(const std::map<std::string,E>& value, Any& a)
     a = Any(m);
 }
 
+template<typename T>
+typename std::enable_if<IsJsonizeFields<T>::value>::type ToAny(const T& value, Any& a)
+{
+    JsonMap m;
+
+    auto visitor = [&m](const char* name, const auto& field) {
+        ToJson(field, m[name]);
+    };
+
+    UtJsonizeFields(visitor, value);
+    a = Any(m);
+}
+
 template<typename T>
 void ToJson(const T& value, Any& a)
 {
@@ -0,0 +1,49 @@
+#ifndef __UT_FUTEX_HPP__
+#define __UT_FUTEX_HPP__
+
+#include <linux/futex.h>
+#include <unitree/common/decl.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: Futex
+ *         Wait/wake on a 32 bit atomic word of this process, without mutex.
+ */
+class Futex
+{
+public:
+    /*
+     * Wait while word equals value, microsec < 0 waits forever.
+     * return false on timeout.
+     */
+    static bool Wait(std::atomic<uint32_t>& word, uint32_t value, int64_t microsec = -1)
+    {
+        struct timespec ts, *pts = NULL;
+        if (microsec >= 0)
+        {
+            ts.tv_sec = microsec / 1000000;
+            ts.tv_nsec = (microsec % 1000000) * 1000;
+            pts = &ts;
+        }
+
+        if (syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT_PRIVATE, value, pts, NULL, 0) == 0)
+        {
+            return true;
+        }
+
+        return errno != ETIMEDOUT;
+    }
+
+    static void Wake(std::atomic<uint32_t>& word, int32_t count = INT_MAX)
+    {
+        syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+};
+
+}
+}
+
+#endif//__UT_FUTEX_HPP__
@@ -0,0 +1,148 @@
+#ifndef __UT_RING_QUEUE_HPP__
+#define __UT_RING_QUEUE_HPP__
+
+#include <unitree/common/exception.hpp>
+#include <unitree/common/lock/lock.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: RingQueue
+ *         Fixed capacity queue of preallocated slots. Put copies into the
+ *         next free slot and evicts the earliest element when full, Get
+ *         copies out into the caller's element, so no allocation happens
+ *         after construction.
+ */
+template<typename T>
+class RingQueue
+{
+public:
+    explicit RingQueue(uint64_t capacity) :
+        mCapacity(capacity), mHead(0), mSize(0), mEvictedCount(0)
+    {
+        if (mCapacity == 0)
+        {
+            UT_THROW(CommonException, "ring queue capacity is zero");
+        }
+
+        mSlots.resize(mCapacity);
+    }
+
+    bool Put(const T& t)
+    {
+        /*
+         * if the earliest element was evicted return false
+         */
+        bool noneEvicted = true;
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (mSize >= mCapacity)
+        {
+            noneEvicted = false;
+
+            mHead = (mHead + 1) % mCapacity;
+            mSize --;
+            mEvictedCount ++;
+        }
+
+        mSlots[(mHead + mSize) % mCapacity] = t;
+
+        mSize ++;
+        mMutexCond.Notify();
+
+        return noneEvicted;
+    }
+
+    bool Get(T& t, uint64_t microsec = 0)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (mSize == 0)
+        {
+            if (!mMutexCond.Wait(microsec))
+            {
+                return false;
+            }
+
+            if (mSize == 0)
+            {
+                return false;
+            }
+        }
+
+        t = mSlots[mHead];
+
+        mHead = (mHead + 1) % mCapacity;
+        mSize --;
+
+        return true;
+    }
+
+    /*
+     * Get without wait, false if queue is empty.
+     */
+    bool TryGet(T& t)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (mSize == 0)
+        {
+            return false;
+        }
+
+        t = mSlots[mHead];
+
+        mHead = (mHead + 1) % mCapacity;
+        mSize --;
+
+        return true;
+    }
+
+    bool Empty()
+    {
+        return mSize == 0;
+    }
+
+    uint64_t Size()
+    {
+        return mSize;
+    }
+
+    uint64_t Capacity() const
+    {
+        return mCapacity;
+    }
+
+    uint64_t GetEvictedCount() const
+    {
+        return mEvictedCount;
+    }
+
+    void Interrupt(bool all = false)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (all)
+        {
+            mMutexCond.NotifyAll();
+        }
+        else
+        {
+            mMutexCond.Notify();
+        }
+    }
+
+private:
+    uint64_t mCapacity;
+    uint64_t mHead;
+    uint64_t mSize;
+    std::atomic<uint64_t> mEvictedCount;
+    std::vector<T> mSlots;
+    MutexCond mMutexCond;
+};
+
+template <typename T>
+using RingQueuePtr = std::shared_ptr<RingQueue<T>>;
+
+}
+}
+#endif//__UT_RING_QUEUE_HPP__
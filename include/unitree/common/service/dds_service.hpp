@@ -52,21 +52,26 @@ public:
 
 protected:
     template<typename MSG>
-    void RegistTopicMessageHandler(const std::string& topic, const DdsMessageHandler& handler)
+    DdsTopicHandle<MSG> RegistTopicMessageHandler(const std::string& topic, const DdsMessageHandler& handler)
     {
-        mModel.SetTopic<MSG>(topic, handler);
+        DdsTopicHandle<MSG> handle = mModel.SetTopic<MSG>(topic, handler);
         LOG_INFO(mLogger, "regist topic reader callback. topic:", topic);
+        return handle;
     }
 
+    /*
+     * Regist topic writer, keep the handle to write at high rate.
+     */
     template<typename MSG>
-    void RegistTopic(const std::string& topic)
+    DdsTopicHandle<MSG> RegistTopic(const std::string& topic)
     {
-        mModel.SetTopic<MSG>(topic);
+        DdsTopicHandle<MSG> handle = mModel.SetTopic<MSG>(topic);
         LOG_INFO(mLogger, "regist topic. topic:", topic);
+        return handle;
     }
 
     /*
-     * Write message to topic
+     * Write message to topic by name
      */
     template<typename MSG>
     void WriteMessage(const std::string& topic, const MSG& message)
@@ -74,6 +79,15 @@ protected:
         mModel.WriteMessage<MSG>(topic, message);
     }
 
+    /*
+     * Write message to topic by handle returned from RegistTopic
+     */
+    template<typename MSG>
+    void WriteMessage(const DdsTopicHandle<MSG>& handle, const MSG& message)
+    {
+        handle.Write(message);
+    }
+
 private:
     bool mQuit;
     DdsEasyModel mModel;
@@ -0,0 +1,159 @@
+#ifndef __UT_LATENCY_HISTOGRAM_HPP__
+#define __UT_LATENCY_HISTOGRAM_HPP__
+
+#include <atomic>
+#include <unitree/common/decl.hpp>
+#include <unitree/common/json/jsonize.hpp>
+
+/*
+ * sub buckets of each power of 2, relative error of a value is below
+ * 1/UT_LATENCY_HISTOGRAM_SUB_COUNT.
+ */
+#define UT_LATENCY_HISTOGRAM_SUB_BITS       4
+#define UT_LATENCY_HISTOGRAM_SUB_COUNT      (1 << UT_LATENCY_HISTOGRAM_SUB_BITS)
+
+/*
+ * largest value of histogram is 2^36 - 1 microseconds (about 19 hours),
+ * larger ones are counted as it.
+ */
+#define UT_LATENCY_HISTOGRAM_VALUE_BITS     36
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief
+ * @class: LatencyHistogram
+ *         HDR style histogram of microseconds. Values below 2 * SUB_COUNT are
+ *         counted exactly, larger ones in SUB_COUNT buckets per power of 2.
+ *         Record is lock free and can be called from any thread.
+ */
+class LatencyHistogram
+{
+public:
+    enum
+    {
+        BUCKET_COUNT = 2 * UT_LATENCY_HISTOGRAM_SUB_COUNT +
+            (UT_LATENCY_HISTOGRAM_VALUE_BITS - UT_LATENCY_HISTOGRAM_SUB_BITS - 1) * UT_LATENCY_HISTOGRAM_SUB_COUNT
+    };
+
+    LatencyHistogram() :
+        mCount(0), mSum(0), mMax(0)
+    {
+        for (uint32_t i=0; i<BUCKET_COUNT; i++)
+        {
+            mBuckets[i] = 0;
+        }
+    }
+
+    void Record(uint64_t microsec)
+    {
+        mBuckets[GetIndex(microsec)].fetch_add(1, std::memory_order_relaxed);
+        mCount.fetch_add(1, std::memory_order_relaxed);
+        mSum.fetch_add(microsec, std::memory_order_relaxed);
+
+        uint64_t max = mMax.load(std::memory_order_relaxed);
+        while (microsec > max && !mMax.compare_exchange_weak(max, microsec, std::memory_order_relaxed))
+        {}
+    }
+
+    uint64_t GetCount() const
+    {
+        return mCount.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Smallest value not less than ratio of values, e.g. 0.99 for p99.
+     * Value is the upper bound of its bucket.
+     */
+    uint64_t GetPercentile(double ratio) const
+    {
+        uint64_t count = GetCount();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t rank = (uint64_t)(ratio * count + 0.5);
+        if (rank == 0)
+        {
+            rank = 1;
+        }
+
+        uint64_t seen = 0;
+        for (uint32_t i=0; i<BUCKET_COUNT; i++)
+        {
+            seen += mBuckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                return std::min(GetUpperValue(i), mMax.load(std::memory_order_relaxed));
+            }
+        }
+
+        return mMax.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * count, mean, p50, p90, p99, p999 and max.
+     */
+    void toJson(JsonMap& json) const
+    {
+        uint64_t count = GetCount();
+
+        ToJson(count, json["count"]);
+        ToJson(count > 0 ? mSum.load(std::memory_order_relaxed) / count : (uint64_t)0, json["mean"]);
+        ToJson(GetPercentile(0.5), json["p50"]);
+        ToJson(GetPercentile(0.9), json["p90"]);
+        ToJson(GetPercentile(0.99), json["p99"]);
+        ToJson(GetPercentile(0.999), json["p999"]);
+        ToJson(mMax.load(std::memory_order_relaxed), json["max"]);
+    }
+
+    static uint32_t GetIndex(uint64_t value)
+    {
+        const uint64_t exactCount = 2 * UT_LATENCY_HISTOGRAM_SUB_COUNT;
+
+        if (value < exactCount)
+        {
+            return (uint32_t)value;
+        }
+
+        if (value >> UT_LATENCY_HISTOGRAM_VALUE_BITS)
+        {
+            value = (1ULL << UT_LATENCY_HISTOGRAM_VALUE_BITS) - 1;
+        }
+
+        uint32_t msb = 63 - __builtin_clzll(value);
+        uint32_t shift = msb - UT_LATENCY_HISTOGRAM_SUB_BITS;
+        uint32_t sub = (uint32_t)(value >> shift) - UT_LATENCY_HISTOGRAM_SUB_COUNT;
+
+        return exactCount + (shift - 1) * UT_LATENCY_HISTOGRAM_SUB_COUNT + sub;
+    }
+
+    static uint64_t GetUpperValue(uint32_t index)
+    {
+        const uint32_t exactCount = 2 * UT_LATENCY_HISTOGRAM_SUB_COUNT;
+
+        if (index < exactCount)
+        {
+            return index;
+        }
+
+        uint32_t shift = (index - exactCount) / UT_LATENCY_HISTOGRAM_SUB_COUNT + 1;
+        uint64_t top = (index - exactCount) % UT_LATENCY_HISTOGRAM_SUB_COUNT + UT_LATENCY_HISTOGRAM_SUB_COUNT;
+
+        return ((top + 1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t> mCount;
+    std::atomic<uint64_t> mSum;
+    std::atomic<uint64_t> mMax;
+    std::atomic<uint64_t> mBuckets[BUCKET_COUNT];
+};
+
+}
+}
+
+#endif//__UT_LATENCY_HISTOGRAM_HPP__
@@ -0,0 +1,260 @@
+#ifndef __UT_ROBOT_B2_CACHED_CONFIG_CLIENT_HPP__
+#define __UT_ROBOT_B2_CACHED_CONFIG_CLIENT_HPP__
+
+#include <unordered_map>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/robot/b2/config/config_client.hpp>
+
+/*
+ * cached content older than this is checked against epoch and size of
+ * config meta before used, in case a change notification is lost.
+ */
+#define UT_ROBOT_CONFIG_CACHE_VALIDATE_MICROSEC     1000000
+
+namespace unitree
+{
+namespace robot
+{
+namespace b2
+{
+/*
+ * @brief CachedConfigClient
+ *        ConfigClient keeping content of configs got. Cached content is
+ *        dropped by change notification of the config, by Set or Del of this
+ *        client, and when epoch or size of meta moves. Get of a fresh config
+ *        is a hash lookup without calling service, a miss is one Get of
+ *        service, and a cache older than validate interval one Meta.
+ *        Set, Get, Del and SubscribeChangeStatus hide the methods of
+ *        ConfigClient, which are not virtual. Call them on the
+ *        CachedConfigClient, calls through a ConfigClient pointer or
+ *        reference bypass the cache and leave it stale until the change
+ *        notification or the next validation.
+ */
+class CachedConfigClient : public ConfigClient
+{
+public:
+    CachedConfigClient() :
+        mValidateInterval(UT_ROBOT_CONFIG_CACHE_VALIDATE_MICROSEC), mCachePtr(new Cache())
+    {}
+
+    /*
+     * ConfigClient stops change notifications only after members here are
+     * gone, a callback still running keeps the cache until it returns.
+     */
+    ~CachedConfigClient()
+    {
+        mCachePtr.reset();
+    }
+
+    /*
+     * 0 trusts change notifications only.
+     */
+    void SetValidateInterval(uint64_t microsec)
+    {
+        mValidateInterval = microsec;
+    }
+
+    int32_t Set(const std::string& name, const std::string& content)
+    {
+        int32_t ret = ConfigClient::Set(name, content);
+        Invalidate(name);
+
+        return ret;
+    }
+
+    int32_t Get(const std::string& name, std::string& content)
+    {
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+
+        bool valid = false, subscribe = false;
+        int32_t epoch = -1, size = -1;
+        uint64_t generation = 0;
+
+        {
+            common::LockGuard<common::Mutex> guard(mCachePtr->mLock);
+
+            Entry& entry = mCachePtr->mEntries[name];
+            if (entry.mValid && (mValidateInterval == 0 || now < entry.mValidateTime + mValidateInterval))
+            {
+                content = entry.mContent;
+                return UT_ROBOT_OK;
+            }
+
+            valid = entry.mValid;
+            epoch = entry.mEpoch;
+            size = entry.mSize;
+            generation = entry.mGeneration;
+
+            subscribe = !entry.mSubscribed;
+            entry.mSubscribed = true;
+        }
+
+        if (subscribe)
+        {
+            Subscribe(name);
+        }
+
+        /*
+         * a cached content is validated by meta. Meta goes before content,
+         * a change between them leaves a newer content with an older epoch,
+         * which is only fetched again. Content not cached is fetched without
+         * meta, and kept with epoch unknown until its first validation.
+         */
+        ConfigMeta meta;
+
+        if (valid)
+        {
+            int32_t ret = Meta(name, meta);
+            if (ret != UT_ROBOT_OK)
+            {
+                return ret;
+            }
+
+            if (epoch >= 0 && meta.epoch == epoch && meta.size == size)
+            {
+                common::LockGuard<common::Mutex> guard(mCachePtr->mLock);
+
+                Entry& entry = mCachePtr->mEntries[name];
+                if (entry.mValid && entry.mGeneration == generation)
+                {
+                    entry.mValidateTime = now;
+                    content = entry.mContent;
+                    return UT_ROBOT_OK;
+                }
+            }
+        }
+
+        int32_t ret = ConfigClient::Get(name, content);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        common::LockGuard<common::Mutex> guard(mCachePtr->mLock);
+
+        /*
+         * a change notified while fetching makes content stale, not kept.
+         */
+        Entry& entry = mCachePtr->mEntries[name];
+        if (entry.mGeneration == generation)
+        {
+            entry.mValid = true;
+            entry.mEpoch = meta.epoch;
+            entry.mSize = meta.size;
+            entry.mValidateTime = now;
+            entry.mContent = content;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    int32_t Del(const std::string& name)
+    {
+        int32_t ret = ConfigClient::Del(name);
+        Invalidate(name);
+
+        return ret;
+    }
+
+    void SubscribeChangeStatus(const std::string& name, const ConfigChangeStatusCallback& callback)
+    {
+        bool subscribe = false;
+
+        {
+            common::LockGuard<common::Mutex> guard(mCachePtr->mLock);
+
+            Entry& entry = mCachePtr->mEntries[name];
+            entry.mCallback = callback;
+
+            subscribe = !entry.mSubscribed;
+            entry.mSubscribed = true;
+        }
+
+        if (subscribe)
+        {
+            Subscribe(name);
+        }
+    }
+
+    void Invalidate(const std::string& name)
+    {
+        common::LockGuard<common::Mutex> guard(mCachePtr->mLock);
+
+        auto iter = mCachePtr->mEntries.find(name);
+        if (iter != mCachePtr->mEntries.end())
+        {
+            iter->second.mValid = false;
+            iter->second.mGeneration++;
+            iter->second.mContent.clear();
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Entry() :
+            mValid(false), mSubscribed(false), mEpoch(-1), mSize(-1), mGeneration(0), mValidateTime(0)
+        {}
+
+        bool mValid;
+        bool mSubscribed;
+        int32_t mEpoch;
+        int32_t mSize;
+        uint64_t mGeneration;
+        uint64_t mValidateTime;
+        std::string mContent;
+        ConfigChangeStatusCallback mCallback;
+    };
+
+    struct Cache
+    {
+        common::Mutex mLock;
+        std::unordered_map<std::string,Entry> mEntries;
+    };
+
+    using CachePtr = std::shared_ptr<Cache>;
+
+    void Subscribe(const std::string& name)
+    {
+        std::weak_ptr<Cache> cacheWeakPtr = mCachePtr;
+
+        ConfigClient::SubscribeChangeStatus(name, [cacheWeakPtr, name](const std::string& changedName, const std::string& content) {
+            CachePtr cachePtr = cacheWeakPtr.lock();
+            if (cachePtr)
+            {
+                OnChangeStatus(*cachePtr, name, changedName, content);
+            }
+        });
+    }
+
+    static void OnChangeStatus(Cache& cache, const std::string& name, const std::string& changedName, const std::string& content)
+    {
+        ConfigChangeStatusCallback callback;
+
+        {
+            common::LockGuard<common::Mutex> guard(cache.mLock);
+
+            Entry& entry = cache.mEntries[name];
+            entry.mValid = false;
+            entry.mGeneration++;
+            entry.mContent.clear();
+
+            callback = entry.mCallback;
+        }
+
+        if (callback)
+        {
+            callback(changedName, content);
+        }
+    }
+
+private:
+    uint64_t mValidateInterval;
+    CachePtr mCachePtr;
+};
+
+}
+}
+}
+
+#endif//__UT_ROBOT_B2_CACHED_CONFIG_CLIENT_HPP__
@@ -13,6 +13,23 @@ using Channel = unitree::common::DdsTopicChannel<MSG>;
 template<typename MSG>
 using ChannelPtr = unitree::common::DdsTopicChannelPtr<MSG>;
 
+template<typename MSG>
+using RpcChannelPtr = unitree::common::DdsRpcChannelPtr<MSG>;
+
+template<typename MSG>
+using ChannelLoanedMessage = unitree::common::DdsLoanedMessage<MSG>;
+
+template<typename MSG>
+using ChannelMessageHandler = unitree::common::DdsTypedMessageHandler<MSG>;
+
+template<typename MSG>
+using ChannelLoanedMessageHandler = unitree::common::DdsLoanedMessageHandler<MSG>;
+
+using ChannelPublishBatch = unitree::common::DdsWriteBatch;
+
+using ChannelExecutorClassConfig = unitree::common::DdsExecutorClassConfig;
+using ChannelExecutorConfig = unitree::common::DdsExecutorConfig;
+
 class ChannelFactory
 {
 public:
@@ -26,24 +43,180 @@ public:
     void Init(const std::string& configFileName = "");
     void Init(const common::JsonMap& jsonMap);
 
+    /*
+     * Init with executor config, the dispatcher pool of recv channel callbacks.
+     * A config file section can be parsed by common::DdsExecutorConfigFromJson.
+     * Executor classes of a repeated Init must have the same config.
+     */
+    void Init(int32_t domainId, const std::string& networkInterface, const ChannelExecutorConfig& executorConfig)
+    {
+        InitExecutor(executorConfig);
+        Init(domainId, networkInterface);
+    }
+
+    void Init(const common::JsonMap& jsonMap, const ChannelExecutorConfig& executorConfig)
+    {
+        InitExecutor(executorConfig);
+        Init(jsonMap);
+    }
+
+    void InitExecutor(const ChannelExecutorConfig& executorConfig)
+    {
+        common::DdsExecutor::Instance()->Init(executorConfig);
+    }
+
+    /*
+     * Per-topic qos profiles from the Topic/Writer/Reader sections of dds
+     * parameter, names may be fnmatch patterns. Applies to channels created
+     * after it is called, usually with the map given to Init.
+     */
+    void InitQosProfile(const common::JsonMap& jsonMap)
+    {
+        mQosProfileSet.Init(jsonMap);
+    }
+
+    void Init(const common::JsonMap& jsonMap, bool qosProfile)
+    {
+        Init(jsonMap);
+        if (qosProfile)
+        {
+            InitQosProfile(jsonMap);
+        }
+    }
+
     void Release();
 
+    /*
+     * Same-host shared memory transport for fixed size topics, remote
+     * readers still use dds. Applies to channels created after it is set.
+     */
+    void EnableShmTransport(bool enable = true)
+    {
+        mShmTransport = enable;
+    }
+
+    bool IsShmTransportEnabled() const
+    {
+        return mShmTransport;
+    }
+
+    /*
+     * Deliver messages of send channels directly to recv channels of the same
+     * topic in this process, remote readers still use dds. Without queue the
+     * recv handler runs on the writing thread, serialized with calls from dds
+     * and shm, one call at a time. Applies to channels created after it is
+     * set.
+     */
+    void EnableIntraProcess(bool enable = true)
+    {
+        mIntraProcess = enable;
+    }
+
+    bool IsIntraProcessEnabled() const
+    {
+        return mIntraProcess;
+    }
+
+    /*
+     * Send channels created after it is set use dds write batching: writes
+     * within a PublishBatch stay in the writer until it ends, writes outside
+     * one are sent at once. Batching is switched on for the domain while
+     * such a writer is created, a writer created meanwhile by another
+     * thread, e.g. of a client, batches too, so create these channels first.
+     */
+    void EnableWriteBatch(bool enable = true)
+    {
+        mWriteBatch = enable;
+    }
+
+    bool IsWriteBatchEnabled() const
+    {
+        return mWriteBatch;
+    }
+
+    /*
+     * Run func and flush each batch capable send channel written in it once
+     * when it returns, for publishers written once per control tick. Writes
+     * of a channel in the tick go out in as few packets as they fit.
+     */
+    void PublishBatch(const std::function<void()>& func)
+    {
+        ChannelPublishBatch batch;
+        func();
+    }
+
     template<typename MSG>
     ChannelPtr<MSG> CreateSendChannel(const std::string& name)
     {
-        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name);
+        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name, mQosProfileSet.Find(name));
+        channelPtr->SetShmTransport(mShmTransport);
+        channelPtr->SetIntraProcess(mIntraProcess);
+        channelPtr->SetWriteBatch(mWriteBatch);
         mDdsFactoryPtr->SetWriter(channelPtr);
         return channelPtr;
     }
 
     template<typename MSG>
-    ChannelPtr<MSG> CreateRecvChannel(const std::string& name, std::function<void(const void*)> callback, int32_t queuelen = 0)
+    ChannelPtr<MSG> CreateRecvChannel(const std::string& name, std::function<void(const void*)> callback, int32_t queuelen = 0, const std::string& executorClass = "")
     {
-        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name);
+        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name, mQosProfileSet.Find(name));
+        channelPtr->SetShmTransport(mShmTransport);
+        channelPtr->SetIntraProcess(mIntraProcess);
+        channelPtr->SetExecutorClass(executorClass);
         mDdsFactoryPtr->SetReader(channelPtr, callback, queuelen);
         return channelPtr;
     }
 
+    template<typename MSG>
+    ChannelPtr<MSG> CreateRecvChannel(const std::string& name, const ChannelMessageHandler<MSG>& handler, int32_t queuelen = 0, const std::string& executorClass = "")
+    {
+        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name, mQosProfileSet.Find(name));
+        channelPtr->SetShmTransport(mShmTransport);
+        channelPtr->SetIntraProcess(mIntraProcess);
+        channelPtr->SetExecutorClass(executorClass);
+        mDdsFactoryPtr->SetTypedReader<MSG>(channelPtr, handler, queuelen);
+        return channelPtr;
+    }
+
+    template<typename MSG>
+    ChannelPtr<MSG> CreateRecvChannel(const std::string& name, const ChannelLoanedMessageHandler<MSG>& handler)
+    {
+        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name, mQosProfileSet.Find(name));
+        mDdsFactoryPtr->SetLoanedReader<MSG>(channelPtr, handler);
+        return channelPtr;
+    }
+
+    /*
+     * Channels of service requests and responses used by header code,
+     * they are not DdsTopicChannel, see common::DdsRpcChannel.
+     */
+    template<typename MSG>
+    RpcChannelPtr<MSG> CreateRpcSendChannel(const std::string& name)
+    {
+        RpcChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateRpcChannel<MSG>(name, mQosProfileSet.Find(name));
+        mDdsFactoryPtr->SetRpcWriter(channelPtr);
+        return channelPtr;
+    }
+
+    template<typename MSG>
+    RpcChannelPtr<MSG> CreateRpcRecvChannel(const std::string& name, const ChannelMessageHandler<MSG>& handler)
+    {
+        RpcChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateRpcChannel<MSG>(name, mQosProfileSet.Find(name));
+        mDdsFactoryPtr->SetRpcReader(channelPtr, handler);
+        return channelPtr;
+    }
+
+    /*
+     * Recv channel without callback, read by ChannelSubscriber polling.
+     */
+    template<typename MSG>
+    ChannelPtr<MSG> CreatePollingRecvChannel(const std::string& name)
+    {
+        ChannelPtr<MSG> channelPtr = mDdsFactoryPtr->CreateTopicChannel<MSG>(name, mQosProfileSet.Find(name));
+        mDdsFactoryPtr->SetPollingReader<MSG>(channelPtr);
+        return channelPtr;
+    }
+
 public:
     ~ChannelFactory();
 
@@ -54,6 +227,11 @@ private:
     bool mInited;
     common::DdsFactoryModelPtr mDdsFactoryPtr;
     common::Mutex mMutex;
+
+    inline static bool mShmTransport = false;
+    inline static bool mIntraProcess = false;
+    inline static bool mWriteBatch = false;
+    inline static common::DdsQosProfileSet mQosProfileSet;
 };
 
 }
@@ -11,6 +11,18 @@ const std::string ROBOT_SDK_CHANNEL_PREFIX = "rt/api/";
 const std::string ROBOT_SDK_CHANNEL_SUFFIX_CLIENT = "/request";
 const std::string ROBOT_SDK_CHANNEL_SUFFIX_SERVER = "/response";
 
+/*
+ * @brief  Response channel routed to one client transport, route is the tag
+ *         of its request ids.
+ */
+inline std::string GetRouteChannelName(const std::string& name, uint32_t route)
+{
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "/%08x", route);
+
+    return ROBOT_SDK_CHANNEL_PREFIX + name + ROBOT_SDK_CHANNEL_SUFFIX_SERVER + suffix;
+}
+
 /*
  * @brief
  * @class: ChannelNamer
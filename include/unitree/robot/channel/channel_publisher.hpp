@@ -30,6 +30,19 @@ public:
         return false;
     }
 
+    /*
+     * Wait until count subscribers are matched, false on timeout.
+     */
+    bool WaitForSubscribers(int32_t count, int64_t timeoutMicrosec)
+    {
+        if (mChannelPtr)
+        {
+            return mChannelPtr->WaitMatched(count, timeoutMicrosec);
+        }
+
+        return false;
+    }
+
     void CloseChannel()
     {
         mChannelPtr.reset();
@@ -19,6 +19,22 @@ public:
         mChannelName(channelName), mQueueLen(queuelen), mHandler(handler)
     {}
 
+    /*
+     * Typed handler. Without queue the message is a reference into the reader
+     * loan, valid only during the call, and is not copied.
+     */
+    explicit ChannelSubscriber(const std::string& channelName, const ChannelMessageHandler<MSG>& handler, int64_t queuelen = 0) :
+        mChannelName(channelName), mQueueLen(queuelen), mMessageHandler(handler)
+    {}
+
+    /*
+     * Loaned handler. The handle can be kept after the call returns, the loan
+     * is returned to the reader when the last handle is released.
+     */
+    explicit ChannelSubscriber(const std::string& channelName, const ChannelLoanedMessageHandler<MSG>& handler) :
+        mChannelName(channelName), mQueueLen(0), mLoanedMessageHandler(handler)
+    {}
+
     void InitChannel(const std::function<void(const void*)>& handler, int64_t queuelen = 0)
     {
         mHandler = handler;
@@ -27,11 +43,44 @@ public:
         InitChannel();
     }
 
+    void InitChannel(const ChannelMessageHandler<MSG>& handler, int64_t queuelen = 0)
+    {
+        mMessageHandler = handler;
+        mQueueLen = queuelen;
+
+        InitChannel();
+    }
+
+    void InitChannel(const ChannelLoanedMessageHandler<MSG>& handler)
+    {
+        mLoanedMessageHandler = handler;
+        mQueueLen = 0;
+
+        InitChannel();
+    }
+
+    /*
+     * Executor class running the handler, set before InitChannel. A handler
+     * with a class is always queued, the loaned handler ignores it.
+     */
+    void SetExecutorClass(const std::string& executorClass)
+    {
+        mExecutorClass = executorClass;
+    }
+
     void InitChannel()
     {
-        if (mHandler)
+        if (mLoanedMessageHandler)
+        {
+            mChannelPtr = ChannelFactory::Instance()->CreateRecvChannel<MSG>(mChannelName, mLoanedMessageHandler);
+        }
+        else if (mMessageHandler)
+        {
+            mChannelPtr = ChannelFactory::Instance()->CreateRecvChannel<MSG>(mChannelName, mMessageHandler, mQueueLen, mExecutorClass);
+        }
+        else if (mHandler)
         {
-            mChannelPtr = ChannelFactory::Instance()->CreateRecvChannel<MSG>(mChannelName, mHandler, mQueueLen);
+            mChannelPtr = ChannelFactory::Instance()->CreateRecvChannel<MSG>(mChannelName, mHandler, mQueueLen, mExecutorClass);
         }
         else
         {
@@ -39,6 +88,56 @@ public:
         }
     }
 
+    /*
+     * Polling mode, no handler and no thread. The latest message is read
+     * by TryTakeLatest or ReadLatest on caller's thread.
+     */
+    void InitPollingChannel()
+    {
+        mChannelPtr = ChannelFactory::Instance()->CreatePollingRecvChannel<MSG>(mChannelName);
+    }
+
+    /*
+     * Take the latest message if it is new since last take or read, it is
+     * no longer returned by ReadLatest.
+     */
+    bool TryTakeLatest(MSG& message)
+    {
+        int64_t sourceTimestamp = 0;
+        return TryTakeLatest(message, sourceTimestamp);
+    }
+
+    bool TryTakeLatest(MSG& message, int64_t& sourceTimestamp)
+    {
+        if (!mChannelPtr || !mChannelPtr->GetReader())
+        {
+            return false;
+        }
+
+        return mChannelPtr->GetReader()->TakeLatest(message, sourceTimestamp);
+    }
+
+    /*
+     * Copy the latest message whether it is new or not, false if none
+     * received since last take.
+     */
+    bool ReadLatest(MSG& message)
+    {
+        int64_t sourceTimestamp = 0;
+        bool isNew = false;
+        return ReadLatest(message, sourceTimestamp, isNew);
+    }
+
+    bool ReadLatest(MSG& message, int64_t& sourceTimestamp, bool& isNew)
+    {
+        if (!mChannelPtr || !mChannelPtr->GetReader())
+        {
+            return false;
+        }
+
+        return mChannelPtr->GetReader()->ReadLatest(message, sourceTimestamp, isNew);
+    }
+
     void CloseChannel()
     {
         mChannelPtr.reset();
@@ -54,6 +153,19 @@ public:
         return -1;
     }
 
+    /*
+     * Count of earliest messages evicted from the queue, 0 without queue.
+     */
+    uint64_t GetEvictedCount() const
+    {
+        if (mChannelPtr)
+        {
+            return mChannelPtr->GetEvictedCount();
+        }
+
+        return 0;
+    }
+
     const std::string& GetChannelName() const
     {
         return mChannelName;
@@ -62,7 +174,10 @@ public:
 private:
     std::string mChannelName;
     int64_t mQueueLen;
+    std::string mExecutorClass;
     std::function<void(const void*)> mHandler;
+    ChannelMessageHandler<MSG> mMessageHandler;
+    ChannelLoanedMessageHandler<MSG> mLoanedMessageHandler;
     ChannelPtr<MSG> mChannelPtr;
 };
 
@@ -43,6 +43,28 @@ protected:
 
     int32_t Call(int32_t apiId, const std::string& parameter, const std::vector<uint8_t>& binary);
 
+    /*
+     * Async call of registed api, Get on the future waits the response.
+     */
+    ClientFuturePtr CallAsync(int32_t apiId, const std::string& parameter)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckApi(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ClientFuturePtr(new ClientFuture(ret));
+        }
+
+        return ClientBase::CallAsync(apiId, parameter, priority, leaseId);
+    }
+
+    void CallAsync(int32_t apiId, const std::string& parameter, const ClientCallback& callback)
+    {
+        RunCallback(CallAsync(apiId, parameter), callback);
+    }
+
     void RegistApi(int32_t apiId, int32_t priority = 0);
     int32_t CheckApi(int32_t apiId, int32_t& priority, int64_t& leaseId);
 
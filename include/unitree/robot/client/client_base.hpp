@@ -2,6 +2,7 @@
 #define __UT_ROBOT_SDK_CLIENT_BASE_HPP__
 
 #include <unitree/robot/client/client_stub.hpp>
+#include <unitree/robot/client/client_future.hpp>
 
 namespace unitree
 {
@@ -39,8 +40,45 @@ protected:
 
     int32_t Call(int32_t apiId, const std::string& parameter, std::string& data, int32_t priority, int64_t leaseId, int64_t timeout);
 
+    /*
+     * Send request and return without waiting response, many calls can be
+     * in flight on one client.
+     */
+    ClientFuturePtr CallAsync(int32_t apiId, const std::string& parameter, int32_t priority, int64_t leaseId)
+    {
+        Request request;
+        SetHeader(request.header(), apiId, leaseId, priority, false);
+        request.parameter() = parameter;
+
+        RequestFuturePtr futurePtr = mClientStubPtr->SendRequest(request, mTimeout);
+        if (!futurePtr)
+        {
+            return ClientFuturePtr(new ClientFuture(UT_ROBOT_ERR_CLIENT_SEND));
+        }
+
+        return ClientFuturePtr(new ClientFuture(apiId, futurePtr, mTimeout));
+    }
+
+    /*
+     * Callback is called with result on the async callback thread.
+     */
+    void CallAsync(int32_t apiId, const std::string& parameter, const ClientCallback& callback, int32_t priority, int64_t leaseId)
+    {
+        RunCallback(CallAsync(apiId, parameter, priority, leaseId), callback);
+    }
+
+    static void RunCallback(const ClientFuturePtr& futurePtr, const ClientCallback& callback)
+    {
+        ClientCallbackDispatcher::Instance()->Add(futurePtr, callback);
+    }
+
     void SetHeader(RequestHeader& header, int32_t apiId, int64_t leaseId, int32_t priority, bool noReply);
 
+    int64_t GetTimeout() const
+    {
+        return mTimeout;
+    }
+
 private:
     int64_t mTimeout;
     ClientStubPtr mClientStubPtr;
@@ -0,0 +1,451 @@
+#ifndef __UT_ROBOT_SDK_CLIENT_FUTURE_HPP__
+#define __UT_ROBOT_SDK_CLIENT_FUTURE_HPP__
+
+#include <deque>
+#include <unitree/common/thread/thread.hpp>
+#include <unitree/robot/future/request_future.hpp>
+#include <unitree/robot/client/client_transport.hpp>
+
+/*
+ * max wait of callback thread without pending call. 100ms
+ */
+#define UT_ROBOT_CLIENT_ASYNC_IDLE_MICROSEC     100000
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * Called once when an async call completes, with code of call and time its
+ * response was ready, 0 if no response came.
+ */
+using ClientCompleteHook = std::function<void(int32_t code, uint64_t readyTime)>;
+
+/*
+ * @brief
+ * @class: ClientFuture
+ *         Result of an async call. The call times out at the client timeout
+ *         counted from the time it was sent.
+ */
+class ClientFuture
+{
+public:
+    explicit ClientFuture(int32_t code) :
+        mApiId(0), mDeadline(0), mDone(true), mCode(code), mRequestId(0)
+    {}
+
+    explicit ClientFuture(int32_t apiId, const RequestFuturePtr& futurePtr, int64_t timeout) :
+        mApiId(apiId), mDeadline(common::GetCurrentMonotonicTimeMicrosecond() + timeout),
+        mDone(false), mCode(UT_ROBOT_ERR_UNKNOWN), mRequestId(0), mFuturePtr(futurePtr)
+    {}
+
+    /*
+     * Request sent by transport, its slot is released by Get or destructor.
+     * The future holds the transport until then.
+     */
+    explicit ClientFuture(int32_t apiId, const ClientTransportPtr& transportPtr, int64_t requestId, int64_t timeout,
+        const ClientCompleteHook& hook = ClientCompleteHook()) :
+        mApiId(apiId), mDeadline(common::GetCurrentMonotonicTimeMicrosecond() + timeout),
+        mDone(false), mCode(UT_ROBOT_ERR_UNKNOWN), mRequestId(requestId), mTransportPtr(transportPtr), mHook(hook)
+    {}
+
+    ~ClientFuture()
+    {
+        if (!mDone && mTransportPtr)
+        {
+            mTransportPtr->Release(mRequestId);
+        }
+    }
+
+    /*
+     * Wait response, return code of call.
+     */
+    int32_t Get()
+    {
+        Wait();
+        return mCode;
+    }
+
+    int32_t Get(std::string& data)
+    {
+        Wait();
+
+        if (mResponsePtr)
+        {
+            data = mResponsePtr->data();
+        }
+
+        return mCode;
+    }
+
+    int32_t Get(std::vector<uint8_t>& binary)
+    {
+        Wait();
+
+        if (mResponsePtr)
+        {
+            binary = mResponsePtr->binary();
+        }
+
+        return mCode;
+    }
+
+    /*
+     * Complete call when response is in or call is timed out.
+     */
+    void Wait()
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+        if (mDone)
+        {
+            return;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        Complete((mDeadline > now) ? (mDeadline - now) : 1);
+    }
+
+    int32_t GetApiId() const
+    {
+        return mApiId;
+    }
+
+    /*
+     * Complete call if response is in or call is timed out, without
+     * waiting. Calls sent by client stub are checked by a 1us wait.
+     */
+    bool Poll()
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+        if (mDone)
+        {
+            return true;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+
+        if (now < mDeadline)
+        {
+            if (mTransportPtr)
+            {
+                if (!mTransportPtr->IsReady(mRequestId))
+                {
+                    return false;
+                }
+            }
+            else if (!mFuturePtr->GetResponse(1))
+            {
+                return false;
+            }
+        }
+
+        Complete(1);
+        return true;
+    }
+
+    uint64_t GetDeadline() const
+    {
+        return mDeadline;
+    }
+
+    const ClientTransportPtr& GetTransport() const
+    {
+        return mTransportPtr;
+    }
+
+private:
+    void Complete(int64_t waitTime)
+    {
+        mDone = true;
+
+        ResponsePtr responsePtr;
+        uint64_t readyTime = 0;
+
+        if (mTransportPtr)
+        {
+            const Response* response = mTransportPtr->Wait(mRequestId, waitTime);
+            if (response != NULL)
+            {
+                responsePtr.reset(new Response(*response));
+                readyTime = mTransportPtr->GetReadyTime(mRequestId);
+            }
+
+            mTransportPtr->Release(mRequestId);
+        }
+        else
+        {
+            responsePtr = mFuturePtr->GetResponse(waitTime);
+            mFuturePtr.reset();
+
+            if (responsePtr)
+            {
+                readyTime = common::GetCurrentMonotonicTimeMicrosecond();
+            }
+        }
+
+        if (!responsePtr)
+        {
+            mCode = UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+        }
+        else if (responsePtr->header().identity().api_id() != mApiId)
+        {
+            mCode = UT_ROBOT_ERR_CLIENT_API_NOT_MATCH;
+        }
+        else
+        {
+            mCode = responsePtr->header().status().code();
+            mResponsePtr = responsePtr;
+        }
+
+        if (mHook)
+        {
+            mHook(mCode, readyTime);
+            mHook = ClientCompleteHook();
+        }
+    }
+
+private:
+    int32_t mApiId;
+    uint64_t mDeadline;
+    bool mDone;
+    int32_t mCode;
+
+    int64_t mRequestId;
+    ClientTransportPtr mTransportPtr;
+    ClientCompleteHook mHook;
+
+    common::Mutex mMutex;
+    RequestFuturePtr mFuturePtr;
+    ResponsePtr mResponsePtr;
+};
+
+using ClientFuturePtr = std::shared_ptr<ClientFuture>;
+
+/*
+ * Completion callback of async call, data is empty without response.
+ */
+using ClientCallback = std::function<void(int32_t code, const std::string& data)>;
+
+/*
+ * @brief
+ * @class: ClientCallbackDispatcher
+ *         One thread running completion callbacks of async calls. Calls of
+ *         a transport are completed when its response thread notifies a
+ *         response, and timed out at their deadline. Calls sent by client
+ *         stub are waited one by one on a thread of their own, by the
+ *         condition of their request future, and handed over as they
+ *         complete. A stub call answered before an earlier one waits for
+ *         it. No thread polls a call, callbacks should return soon.
+ */
+class ClientCallbackDispatcher
+{
+public:
+    static ClientCallbackDispatcher* Instance()
+    {
+        static ClientCallbackDispatcher inst;
+        return &inst;
+    }
+
+    ~ClientCallbackDispatcher()
+    {
+        mQuit.store(true);
+
+        {
+            common::LockGuard<common::MutexCond> guard(mMutexCond);
+            mMutexCond.Notify();
+        }
+
+        {
+            common::LockGuard<common::MutexCond> guard(mStubMutexCond);
+            mStubMutexCond.Notify();
+        }
+
+        mThreadPtr->Wait();
+        mStubThreadPtr->Wait();
+    }
+
+    void Add(const ClientFuturePtr& futurePtr, const ClientCallback& callback)
+    {
+        const ClientTransportPtr& transportPtr = futurePtr->GetTransport();
+        if (!transportPtr)
+        {
+            common::LockGuard<common::MutexCond> guard(mStubMutexCond);
+            mStubList.push_back(Pending(futurePtr, callback));
+            mStubMutexCond.Notify();
+
+            return;
+        }
+
+        transportPtr->SetReadyNotifier(std::bind(&ClientCallbackDispatcher::Notify, this));
+
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        mPendingList.push_back(Pending(futurePtr, callback));
+        mPendingCount.store((uint32_t)mPendingList.size());
+
+        mNotified = true;
+        mMutexCond.Notify();
+    }
+
+    /*
+     * Called on response thread when a response is ready.
+     */
+    void Notify()
+    {
+        if (mPendingCount.load() == 0)
+        {
+            return;
+        }
+
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+        mNotified = true;
+        mMutexCond.Notify();
+    }
+
+private:
+    struct Pending
+    {
+        Pending(const ClientFuturePtr& futurePtr, const ClientCallback& callback) :
+            mFuturePtr(futurePtr), mCallback(callback)
+        {}
+
+        ClientFuturePtr mFuturePtr;
+        ClientCallback mCallback;
+    };
+
+    ClientCallbackDispatcher() :
+        mQuit(false), mNotified(false), mPendingCount(0)
+    {
+        mThreadPtr = common::CreateThreadEx("clicb", UT_CPU_ID_NONE, &ClientCallbackDispatcher::ThreadFunction, this);
+        mStubThreadPtr = common::CreateThreadEx("clistub", UT_CPU_ID_NONE, &ClientCallbackDispatcher::StubThreadFunction, this);
+    }
+
+    int32_t ThreadFunction()
+    {
+        std::vector<Pending> doneList;
+
+        while (true)
+        {
+            {
+                common::LockGuard<common::MutexCond> guard(mMutexCond);
+                if (mQuit.load())
+                {
+                    break;
+                }
+
+                if (!mNotified)
+                {
+                    mMutexCond.Wait(GetWaitTime());
+                }
+
+                mNotified = false;
+
+                for (size_t i=0; i<mPendingList.size(); )
+                {
+                    if (mPendingList[i].mFuturePtr->Poll())
+                    {
+                        doneList.push_back(mPendingList[i]);
+                        mPendingList[i] = mPendingList.back();
+                        mPendingList.pop_back();
+                    }
+                    else
+                    {
+                        i++;
+                    }
+                }
+
+                mPendingCount.store((uint32_t)mPendingList.size());
+
+                doneList.insert(doneList.end(), mStubDoneList.begin(), mStubDoneList.end());
+                mStubDoneList.clear();
+            }
+
+            for (const Pending& pending : doneList)
+            {
+                std::string data;
+                int32_t code = pending.mFuturePtr->Get(data);
+                pending.mCallback(code, data);
+            }
+
+            doneList.clear();
+        }
+
+        return 0;
+    }
+
+    /*
+     * Wait calls of client stub in the order sent, without holding any lock
+     * of dispatcher, and hand them to callback thread.
+     */
+    int32_t StubThreadFunction()
+    {
+        while (true)
+        {
+            std::deque<Pending> waitList;
+
+            {
+                common::LockGuard<common::MutexCond> guard(mStubMutexCond);
+                if (mQuit.load())
+                {
+                    break;
+                }
+
+                if (mStubList.empty())
+                {
+                    mStubMutexCond.Wait(UT_ROBOT_CLIENT_ASYNC_IDLE_MICROSEC);
+                    continue;
+                }
+
+                waitList.swap(mStubList);
+            }
+
+            for (const Pending& pending : waitList)
+            {
+                pending.mFuturePtr->Wait();
+
+                common::LockGuard<common::MutexCond> guard(mMutexCond);
+                mStubDoneList.push_back(pending);
+                mNotified = true;
+                mMutexCond.Notify();
+            }
+        }
+
+        return 0;
+    }
+
+    /*
+     * Until the nearest deadline of calls of transport.
+     */
+    int64_t GetWaitTime() const
+    {
+        int64_t waitTime = UT_ROBOT_CLIENT_ASYNC_IDLE_MICROSEC;
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+
+        for (const Pending& pending : mPendingList)
+        {
+            uint64_t deadline = pending.mFuturePtr->GetDeadline();
+            waitTime = std::min<int64_t>(waitTime, (deadline > now) ? (deadline - now) : 1);
+        }
+
+        return waitTime;
+    }
+
+private:
+    std::atomic<bool> mQuit;
+    bool mNotified;
+    std::atomic<uint32_t> mPendingCount;
+
+    common::MutexCond mMutexCond;
+    std::vector<Pending> mPendingList;
+    std::vector<Pending> mStubDoneList;
+    common::ThreadPtr mThreadPtr;
+
+    common::MutexCond mStubMutexCond;
+    std::deque<Pending> mStubList;
+    common::ThreadPtr mStubThreadPtr;
+};
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_CLIENT_FUTURE_HPP__
@@ -0,0 +1,308 @@
+#ifndef __UT_ROBOT_SDK_CLIENT_TRANSPORT_HPP__
+#define __UT_ROBOT_SDK_CLIENT_TRANSPORT_HPP__
+
+#include <unitree/robot/channel/channel_factory.hpp>
+#include <unitree/robot/channel/channel_namer.hpp>
+#include <unitree/robot/future/request_slot_table.hpp>
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * @struct: ClientStreamStatistics
+ *          Sending side of a stream api in process.
+ */
+struct ClientStreamStatistics
+{
+    ClientStreamStatistics() :
+        sentCount(0), failedCount(0), lastSendTime(0)
+    {}
+
+    uint64_t sentCount;
+    uint64_t failedCount;
+    uint64_t lastSendTime;
+};
+
+/*
+ * @brief
+ * @class: ClientTransport
+ *         Request/response channels of one service shared by all clients of
+ *         the service in process. Pending requests are kept in a slot table,
+ *         so a call does not allocate, lock or touch a map.
+ *
+ *         Responses come back on the route channel of the transport, named
+ *         by tag of its request ids, if server routes them (DispatchServer).
+ *         The shared response channel of service is read until the first
+ *         routed response, and read again after a timeout, so servers not
+ *         routing responses keep working.
+ *
+ *         Only CodecClient calls go through a transport. Clients built on
+ *         Client (SportClient, LocoClient, ConfigClient, ...) send by the
+ *         ClientStub of the lib and still decode every response of their
+ *         service. A client moves to routed responses by deriving from
+ *         CodecClient and registering its apis there, with a server
+ *         derived from DispatchServer.
+ */
+class ClientTransport
+{
+public:
+    explicit ClientTransport(const std::string& name) :
+        mName(name), mRouted(false), mSharedOpen(false), mHasReadyNotifier(false)
+    {
+        ChannelNamerPtr namerPtr(new ClientChannelNamer());
+
+        mSendChannelPtr = ChannelFactory::Instance()->CreateRpcSendChannel<Request>(namerPtr->GetSendChannelName(name));
+        mRouteChannelPtr = ChannelFactory::Instance()->CreateRpcRecvChannel<Response>(GetRouteChannelName(name, mSlotTable.GetTag()),
+            std::bind(&ClientTransport::RouteResponseFunc, this, std::placeholders::_1));
+
+        OpenSharedChannel();
+    }
+
+    /*
+     * Transport of service, created on first use and kept for the process.
+     * Async calls hold it too, so it outlives their futures.
+     */
+    static std::shared_ptr<ClientTransport> Get(const std::string& name)
+    {
+        static common::Mutex mutex;
+        static std::map<std::string,std::shared_ptr<ClientTransport>> transportMap;
+
+        common::LockGuard<common::Mutex> guard(mutex);
+
+        std::shared_ptr<ClientTransport>& transportPtr = transportMap[name];
+        if (!transportPtr)
+        {
+            transportPtr.reset(new ClientTransport(name));
+        }
+
+        return transportPtr;
+    }
+
+    const std::string& GetName() const
+    {
+        return mName;
+    }
+
+    bool IsRouted() const
+    {
+        return mRouted;
+    }
+
+    /*
+     * Take a slot and send request with id of the slot. budget > 0 lets
+     * server drop request not dispatched within budget microseconds,
+     * rounded up to UT_ROBOT_REQUEST_BUDGET_UNIT (10ms). A budget over
+     * 40.95s is sent as no deadline.
+     * return request id, or ROBOT_API_ID_NONE if failed.
+     */
+    int64_t Send(Request& request, int64_t waitTimeout, int64_t budget = 0)
+    {
+        if (mRouted && mSharedOpen)
+        {
+            CloseSharedChannel();
+        }
+
+        int64_t requestId = mSlotTable.Acquire(budget);
+        if (requestId == ROBOT_API_ID_NONE)
+        {
+            return ROBOT_API_ID_NONE;
+        }
+
+        request.header().identity().id(requestId);
+
+        if (!mSendChannelPtr->Write(request, waitTimeout))
+        {
+            mSlotTable.Release(requestId);
+            return ROBOT_API_ID_NONE;
+        }
+
+        return requestId;
+    }
+
+    /*
+     * Send request of stream api without waiting reply, request id carries
+     * the next sequence of the api in process.
+     */
+    bool SendStream(Request& request, int64_t waitTimeout)
+    {
+        int32_t apiId = (int32_t)request.header().identity().api_id();
+        uint32_t sequence = 0;
+
+        {
+            common::LockGuard<common::Mutex> guard(mStreamMutex);
+            sequence = ++mStreamMap[apiId].mSequence;
+        }
+
+        request.header().identity().id(mSlotTable.GetRequestId(sequence));
+
+        bool sent = mSendChannelPtr->Write(request, waitTimeout);
+
+        common::LockGuard<common::Mutex> guard(mStreamMutex);
+        ClientStreamStatistics& statistics = mStreamMap[apiId].mStatistics;
+
+        if (sent)
+        {
+            statistics.sentCount ++;
+            statistics.lastSendTime = common::GetCurrentMonotonicTimeMicrosecond();
+        }
+        else
+        {
+            statistics.failedCount ++;
+        }
+
+        return sent;
+    }
+
+    bool GetStreamStatistics(int32_t apiId, ClientStreamStatistics& statistics)
+    {
+        common::LockGuard<common::Mutex> guard(mStreamMutex);
+
+        auto iter = mStreamMap.find(apiId);
+        if (iter == mStreamMap.end())
+        {
+            return false;
+        }
+
+        statistics = iter->second.mStatistics;
+        return true;
+    }
+
+    const Response* Wait(int64_t requestId, int64_t microsec)
+    {
+        const Response* response = mSlotTable.Wait(requestId, microsec);
+        if (response == NULL && mRouted)
+        {
+            /*
+             * server may be restarted as one not routing responses.
+             */
+            mRouted = false;
+            OpenSharedChannel();
+        }
+
+        return response;
+    }
+
+    /*
+     * Whether response of request is in, without waiting.
+     */
+    bool IsReady(int64_t requestId)
+    {
+        return mSlotTable.IsReady(requestId);
+    }
+
+    /*
+     * Notifier called on response thread after a response is ready, set
+     * once by the completion of async calls.
+     */
+    void SetReadyNotifier(const std::function<void()>& notifier)
+    {
+        if (mHasReadyNotifier.load())
+        {
+            return;
+        }
+
+        common::LockGuard<common::Mutex> guard(mMutex);
+        if (!mHasReadyNotifier.load())
+        {
+            mReadyNotifier = notifier;
+            mHasReadyNotifier.store(true);
+        }
+    }
+
+    uint64_t GetReadyTime(int64_t requestId)
+    {
+        return mSlotTable.GetReadyTime(requestId);
+    }
+
+    void Release(int64_t requestId)
+    {
+        mSlotTable.Release(requestId);
+    }
+
+    /*
+     * Route tag of transport, unique among live transports of hosts.
+     */
+    uint32_t GetTag() const
+    {
+        return mSlotTable.GetTag();
+    }
+
+private:
+    struct Stream
+    {
+        Stream() :
+            mSequence(0)
+        {}
+
+        uint32_t mSequence;
+        ClientStreamStatistics mStatistics;
+    };
+
+    void OpenSharedChannel()
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+        if (!mSharedChannelPtr)
+        {
+            ChannelNamerPtr namerPtr(new ClientChannelNamer());
+            mSharedChannelPtr = ChannelFactory::Instance()->CreateRpcRecvChannel<Response>(namerPtr->GetRecvChannelName(mName),
+                std::bind(&ClientTransport::SharedResponseFunc, this, std::placeholders::_1));
+            mSharedOpen = true;
+        }
+    }
+
+    void CloseSharedChannel()
+    {
+        RpcChannelPtr<Response> channelPtr;
+
+        {
+            common::LockGuard<common::Mutex> guard(mMutex);
+            channelPtr.swap(mSharedChannelPtr);
+            mSharedOpen = false;
+        }
+    }
+
+    void RouteResponseFunc(const Response& response)
+    {
+        mRouted = true;
+        Ready(response);
+    }
+
+    void SharedResponseFunc(const Response& response)
+    {
+        Ready(response);
+    }
+
+    void Ready(const Response& response)
+    {
+        if (mSlotTable.Ready(response) && mHasReadyNotifier.load())
+        {
+            mReadyNotifier();
+        }
+    }
+
+private:
+    std::string mName;
+    std::atomic<bool> mRouted;
+    std::atomic<bool> mSharedOpen;
+    std::atomic<bool> mHasReadyNotifier;
+    std::function<void()> mReadyNotifier;
+
+    RequestSlotTable mSlotTable;
+
+    common::Mutex mMutex;
+    RpcChannelPtr<Request> mSendChannelPtr;
+    RpcChannelPtr<Response> mRouteChannelPtr;
+    RpcChannelPtr<Response> mSharedChannelPtr;
+
+    common::Mutex mStreamMutex;
+    std::unordered_map<int32_t,Stream> mStreamMap;
+};
+
+using ClientTransportPtr = std::shared_ptr<ClientTransport>;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_CLIENT_TRANSPORT_HPP__
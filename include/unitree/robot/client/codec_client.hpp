@@ -0,0 +1,986 @@
+#ifndef __UT_ROBOT_SDK_CODEC_CLIENT_HPP__
+#define __UT_ROBOT_SDK_CODEC_CLIENT_HPP__
+
+#include <deque>
+#include <unitree/common/time/sleep.hpp>
+#include <unitree/robot/client/client.hpp>
+#include <unitree/robot/client/lease_manager.hpp>
+#include <unitree/robot/internal/api_latency.hpp>
+#include <unitree/common/codec/binary_codec.hpp>
+
+/*
+ * interval of retrying codec negotiation while server is not reachable.
+ */
+#define UT_ROBOT_CODEC_NEGOTIATE_INTERVAL  1000000
+
+/*
+ * chunk size and chunks in flight of CallChunked, tries of resuming a
+ * transfer without progress, and interval of querying a running one.
+ */
+#define UT_ROBOT_CLIENT_TRANSFER_CHUNK_SIZE     (64 * 1024)
+#define UT_ROBOT_CLIENT_TRANSFER_WINDOW         8
+#define UT_ROBOT_CLIENT_TRANSFER_RETRY          3
+#define UT_ROBOT_CLIENT_TRANSFER_POLL_MICROSEC  10000
+
+#define UT_ROBOT_CLIENT_REG_API_CODEC(apiId, priority, codec) \
+    RegistApi(apiId, priority, codec)
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * Bytes of parameter received by server, and size of parameter.
+ */
+using TransferProgressCallback = std::function<void(uint64_t,uint64_t)>;
+
+/*
+ * @brief
+ * @class: CodecClient
+ *         Client of typed parameter and data. Apis registed with
+ *         ROBOT_API_CODEC_BINARY are called by binary codec once server api
+ *         version has ROBOT_API_VERSION_BINARY_TAG, by json otherwise.
+ *         Calls of registed apis go through the ClientTransport of service,
+ *         shared by clients of the service in process, and carry timeout
+ *         of client as budget, so a DispatchServer drops calls given up.
+ *         Budget goes in 10ms units up to 40.95s, a longer timeout as no
+ *         deadline, and server counts it from taking the request off its
+ *         stub, not from sending.
+ *         Leased clients of a service share one lease of LeaseManager, and
+ *         answered calls count as its renewals if server api version has
+ *         ROBOT_API_VERSION_RENEWAL_TAG. Send, wait and delivery times of
+ *         calls are recorded in ApiLatency. Large binary parameters are sent
+ *         by CallChunked in flow controlled chunks of ROBOT_API_ID_TRANSFER.
+ */
+class CodecClient : public Client
+{
+public:
+    explicit CodecClient(const std::string& name, bool enableLease = false) :
+        Client(name, false), mName(name), mTransport(NULL),
+        mServerCodec(ROBOT_API_CODEC_UNKNOWN), mNegotiateTime(0), mNegotiating(false), mBatchUnsupported(false), mServerTransfer(false),
+        mLatency(ApiLatency::Instance()->Get(name))
+    {
+        Client::RegistApi(ROBOT_API_ID_BATCH, 0);
+        Client::RegistApi(ROBOT_API_ID_TRANSFER, 0);
+
+        if (enableLease)
+        {
+            mLeasePtr = LeaseManager::Instance()->Get(name);
+        }
+    }
+
+    virtual ~CodecClient()
+    {
+        common::LockGuard<common::Mutex> guard(mNegotiateThreadMutex);
+        if (mNegotiateThreadPtr)
+        {
+            mNegotiateThreadPtr->Wait();
+            mNegotiateThreadPtr.reset();
+        }
+    }
+
+    /*
+     * Shared lease of LeaseManager. Client::WaitLeaseApplied and
+     * Client::GetLeaseId are of the lease client of Client, not used here.
+     * Wait at most microsec, return UT_ROBOT_OK once applied,
+     * UT_ROBOT_ERR_CLIENT_API_TIMEOUT if not, or
+     * UT_ROBOT_ERR_CLIENT_LEASE_INVALID if client is not leased.
+     */
+    int32_t WaitSharedLeaseApplied(int64_t microsec)
+    {
+        if (!mLeasePtr)
+        {
+            return UT_ROBOT_ERR_CLIENT_LEASE_INVALID;
+        }
+
+        return mLeasePtr->WaitApplied(microsec);
+    }
+
+    int64_t GetSharedLeaseId()
+    {
+        return mLeasePtr ? mLeasePtr->GetId() : 0;
+    }
+
+    /*
+     * Statistics of stream api sent by clients of service in process.
+     */
+    bool GetStreamStatistics(int32_t apiId, ClientStreamStatistics& statistics)
+    {
+        return GetTransport()->GetStreamStatistics(apiId, statistics);
+    }
+
+    /*
+     * Codec used to call apiId now.
+     */
+    int32_t GetApiCodec(int32_t apiId)
+    {
+        return IsBinaryApi(apiId) ? ROBOT_API_CODEC_BINARY : ROBOT_API_CODEC_JSON;
+    }
+
+protected:
+    using Client::RegistApi;
+
+    void RegistApi(int32_t apiId, int32_t priority, int32_t codec)
+    {
+        Client::RegistApi(apiId, priority);
+
+        if (codec == ROBOT_API_CODEC_BINARY)
+        {
+            Client::RegistApi(ROBOT_API_BINARY_ID(apiId), priority);
+            mBinaryApiSet.insert(apiId);
+        }
+    }
+
+    int32_t Call(int32_t apiId, const std::string& parameter, std::string& data)
+    {
+        Request request;
+        request.parameter() = parameter;
+
+        return Invoke(apiId, request, [&data](const Response& response) {
+            data = response.data();
+        });
+    }
+
+    int32_t Call(int32_t apiId, const std::string& parameter)
+    {
+        Request request;
+        request.parameter() = parameter;
+
+        return Invoke(apiId, request, [](const Response&) {});
+    }
+
+    int32_t Call(int32_t apiId, const std::vector<uint8_t>& parameter, std::vector<uint8_t>& data)
+    {
+        Request request;
+        request.binary() = parameter;
+
+        return Invoke(apiId, request, [&data](const Response& response) {
+            data = response.binary();
+        });
+    }
+
+    int32_t Call(int32_t apiId, const std::vector<uint8_t>& parameter)
+    {
+        Request request;
+        request.binary() = parameter;
+
+        return Invoke(apiId, request, [](const Response&) {});
+    }
+
+    int32_t Call(int32_t apiId, const std::string& parameter, const std::vector<uint8_t>& binary)
+    {
+        Request request;
+        request.parameter() = parameter;
+        request.binary() = binary;
+
+        return Invoke(apiId, request, [](const Response&) {});
+    }
+
+    /*
+     * Call binary api with a large parameter sent in chunks, at most
+     * UT_ROBOT_CLIENT_TRANSFER_WINDOW of them in flight. A lost or timed out
+     * chunk resumes the transfer from what server received. progress is
+     * called as server acknowledges chunks. Parameter of one chunk, or
+     * server without ROBOT_API_VERSION_TRANSFER_TAG, is sent by Call.
+     */
+    int32_t CallChunked(int32_t apiId, const std::vector<uint8_t>& parameter, std::vector<uint8_t>& data,
+        const TransferProgressCallback& progress = TransferProgressCallback())
+    {
+        if (parameter.size() <= UT_ROBOT_CLIENT_TRANSFER_CHUNK_SIZE || !Negotiate() || !mServerTransfer.load())
+        {
+            return Call(apiId, parameter, data);
+        }
+
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckCall(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        TransferParameter transfer;
+        transfer.id = NewTransferId();
+        transfer.apiId = apiId;
+        transfer.chunkSize = UT_ROBOT_CLIENT_TRANSFER_CHUNK_SIZE;
+        transfer.size = parameter.size();
+
+        TransferData result;
+
+        ret = WriteTransfer(transfer, parameter, leaseId, result, progress);
+        if (ret == UT_ROBOT_OK)
+        {
+            ret = ReadTransfer(transfer, leaseId, result, data);
+        }
+
+        transfer.op = ROBOT_TRANSFER_OP_CLOSE;
+        transfer.chunk.clear();
+        SendTransfer(transfer, leaseId, true);
+
+        return (ret == UT_ROBOT_OK) ? result.code : ret;
+    }
+
+    /*
+     * Latency and shared lease are recorded as by Call, when the call
+     * completes on Get or on the callback thread.
+     */
+    ClientFuturePtr CallAsync(int32_t apiId, const std::string& parameter)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckCall(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ClientFuturePtr(new ClientFuture(ret));
+        }
+
+        Request request;
+        SetHeader(request.header(), apiId, leaseId, priority, false);
+        request.parameter() = parameter;
+
+        ClientTransport* transport = GetTransport();
+
+        uint64_t sendTime = common::GetCurrentMonotonicTimeMicrosecond();
+
+        int64_t requestId = transport->Send(request, GetTimeout(), GetTimeout());
+        uint64_t sentTime = mLatency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_SEND, sendTime);
+
+        if (requestId == ROBOT_API_ID_NONE)
+        {
+            return ClientFuturePtr(new ClientFuture(UT_ROBOT_ERR_CLIENT_SEND));
+        }
+
+        if (leaseId != 0)
+        {
+            //kick negotiation, so the shared lease knows whether server renews it
+            NegotiateAsync();
+        }
+
+        ServiceLatency* latency = mLatency;
+        SharedLeasePtr leasePtr = (leaseId != 0) ? mLeasePtr : SharedLeasePtr();
+
+        ClientCompleteHook hook = [apiId, latency, leasePtr, leaseId, sendTime, sentTime](int32_t code, uint64_t readyTime)
+        {
+            if (readyTime == 0)
+            {
+                latency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_WAIT, sentTime);
+                return;
+            }
+
+            readyTime = std::max(readyTime, sentTime);
+            latency->Record(apiId, ROBOT_API_LATENCY_CLIENT_WAIT, readyTime - sentTime);
+            latency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_DELIVERY, readyTime);
+
+            if (!leasePtr)
+            {
+                return;
+            }
+
+            if (code == UT_ROBOT_ERR_SERVER_LEASE_DENIED || code == UT_ROBOT_ERR_SERVER_LEASE_NOT_EXIST)
+            {
+                leasePtr->Reset(leaseId);
+            }
+            else
+            {
+                leasePtr->Refresh(leaseId, sendTime);
+            }
+        };
+
+        return ClientFuturePtr(new ClientFuture(apiId, mTransportPtr, requestId, GetTimeout(), hook));
+    }
+
+    void CallAsync(int32_t apiId, const std::string& parameter, const ClientCallback& callback)
+    {
+        RunCallback(CallAsync(apiId, parameter), callback);
+    }
+
+    /*
+     * Send setpoint of stream api without reply. Server keeps only the newest
+     * setpoint (DispatchServer::RegistStreamHandler), a late server never
+     * blocks the next one.
+     */
+    int32_t Stream(int32_t apiId, const std::string& parameter)
+    {
+        Request request;
+        request.parameter() = parameter;
+
+        return SendStream(apiId, request);
+    }
+
+    int32_t Stream(int32_t apiId, const std::vector<uint8_t>& parameter)
+    {
+        Request request;
+        request.binary() = parameter;
+
+        return SendStream(apiId, request);
+    }
+
+    template<typename PARAM>
+    int32_t StreamCodec(int32_t apiId, const PARAM& parameter)
+    {
+        if (IsBinaryApi(apiId, false))
+        {
+            std::vector<uint8_t> binParameter;
+            common::EncodeBinary(parameter, binParameter);
+
+            return Stream(ROBOT_API_BINARY_ID(apiId), binParameter);
+        }
+
+        return Stream(apiId, common::ToJsonString(parameter));
+    }
+
+    /*
+     * Call apis in order by one request, under one lease check of server.
+     * results has one entry for each call run. Calls are sent one by one
+     * if server does not run batch, each with priority and lease of its own
+     * api. As a batch run by server, return UT_ROBOT_OK once calls are run,
+     * failed or not, callers check results[i].code.
+     */
+    int32_t CallBatch(const std::vector<BatchCall>& calls, std::vector<BatchResult>& results, bool stopOnError = true)
+    {
+        results.clear();
+
+        for (const BatchCall& call : calls)
+        {
+            int32_t priority = 0;
+            int64_t leaseId = 0;
+
+            int32_t ret = CheckCall(call.apiId, priority, leaseId);
+            if (ret != UT_ROBOT_OK)
+            {
+                return ret;
+            }
+        }
+
+        if (!mBatchUnsupported)
+        {
+            BatchParameter parameter;
+            parameter.stopOnError = stopOnError;
+            parameter.calls = calls;
+
+            Request request;
+            common::EncodeBinary(parameter, request.binary());
+
+            std::vector<uint8_t> binData;
+
+            int32_t ret = Invoke(ROBOT_API_ID_BATCH, request, [&binData](const Response& response) {
+                binData = response.binary();
+            });
+
+            if (ret != UT_ROBOT_ERR_SERVER_API_NOT_IMPL)
+            {
+                BatchData data;
+                if (ret == UT_ROBOT_OK && !common::DecodeBinary(binData, data))
+                {
+                    ret = UT_ROBOT_ERR_CLIENT_API_DATA;
+                }
+
+                results.swap(data.results);
+                return ret;
+            }
+
+            mBatchUnsupported = true;
+        }
+
+        for (const BatchCall& call : calls)
+        {
+            results.emplace_back();
+            BatchResult& result = results.back();
+
+            Request request;
+            request.parameter() = call.parameter;
+            request.binary() = call.binary;
+
+            result.code = Invoke(call.apiId, request, [&result](const Response& response) {
+                result.data = response.data();
+                result.binary = response.binary();
+            });
+
+            if (result.code != UT_ROBOT_OK && stopOnError)
+            {
+                break;
+            }
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    template<typename PARAM, typename DATA>
+    int32_t CallCodec(int32_t apiId, const PARAM& parameter, DATA& data)
+    {
+        if (IsBinaryApi(apiId))
+        {
+            std::vector<uint8_t> binParameter, binData;
+            common::EncodeBinary(parameter, binParameter);
+
+            int32_t ret = Call(ROBOT_API_BINARY_ID(apiId), binParameter, binData);
+            if (ret != UT_ROBOT_ERR_SERVER_API_NOT_IMPL)
+            {
+                if (ret == UT_ROBOT_OK && !common::DecodeBinary(binData, data))
+                {
+                    ret = UT_ROBOT_ERR_CLIENT_API_DATA;
+                }
+
+                return ret;
+            }
+
+            ResetNegotiation();
+        }
+
+        std::string jsonData;
+
+        int32_t ret = Call(apiId, common::ToJsonString(parameter), jsonData);
+        if (ret == UT_ROBOT_OK)
+        {
+            try
+            {
+                common::FromJsonString(jsonData, data);
+            }
+            catch (const common::Exception&)
+            {
+                ret = UT_ROBOT_ERR_CLIENT_API_DATA;
+            }
+        }
+
+        return ret;
+    }
+
+    template<typename PARAM>
+    int32_t CallCodec(int32_t apiId, const PARAM& parameter)
+    {
+        if (IsBinaryApi(apiId))
+        {
+            std::vector<uint8_t> binParameter;
+            common::EncodeBinary(parameter, binParameter);
+
+            int32_t ret = Call(ROBOT_API_BINARY_ID(apiId), binParameter);
+            if (ret != UT_ROBOT_ERR_SERVER_API_NOT_IMPL)
+            {
+                return ret;
+            }
+
+            ResetNegotiation();
+        }
+
+        return Call(apiId, common::ToJsonString(parameter));
+    }
+
+private:
+    template<typename F>
+    int32_t Invoke(int32_t apiId, Request& request, const F& onResponse)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckCall(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        SetHeader(request.header(), apiId, leaseId, priority, false);
+
+        ClientTransport* transport = GetTransport();
+
+        uint64_t sendTime = common::GetCurrentMonotonicTimeMicrosecond();
+
+        int64_t requestId = transport->Send(request, GetTimeout(), GetTimeout());
+        uint64_t sentTime = mLatency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_SEND, sendTime);
+
+        if (requestId == ROBOT_API_ID_NONE)
+        {
+            return UT_ROBOT_ERR_CLIENT_SEND;
+        }
+
+        const Response* response = transport->Wait(requestId, GetTimeout());
+        if (response == NULL)
+        {
+            ret = UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+            mLatency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_WAIT, sentTime);
+        }
+        else if (response->header().identity().api_id() != apiId)
+        {
+            ret = UT_ROBOT_ERR_CLIENT_API_NOT_MATCH;
+        }
+        else
+        {
+            ret = response->header().status().code();
+            onResponse(*response);
+        }
+
+        if (response != NULL)
+        {
+            uint64_t readyTime = std::max(transport->GetReadyTime(requestId), sentTime);
+            mLatency->Record(apiId, ROBOT_API_LATENCY_CLIENT_WAIT, readyTime - sentTime);
+            mLatency->RecordSince(apiId, ROBOT_API_LATENCY_CLIENT_DELIVERY, readyTime);
+        }
+
+        transport->Release(requestId);
+
+        if (leaseId != 0 && response != NULL)
+        {
+            OnLeaseAnswered(leaseId, sendTime, ret);
+        }
+
+        return ret;
+    }
+
+    /*
+     * CheckApi, with lease id of the shared lease if client is leased.
+     */
+    int32_t CheckCall(int32_t apiId, int32_t& priority, int64_t& leaseId)
+    {
+        int32_t ret = CheckApi(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK || !mLeasePtr)
+        {
+            return ret;
+        }
+
+        leaseId = mLeasePtr->GetId();
+        if (leaseId == 0)
+        {
+            return UT_ROBOT_ERR_CLIENT_LEASE_INVALID;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    void OnLeaseAnswered(int64_t leaseId, uint64_t sendTime, int32_t code)
+    {
+        if (code == UT_ROBOT_ERR_SERVER_LEASE_DENIED || code == UT_ROBOT_ERR_SERVER_LEASE_NOT_EXIST)
+        {
+            mLeasePtr->Reset(leaseId);
+        }
+        else if (Negotiate())
+        {
+            mLeasePtr->Refresh(leaseId, sendTime);
+        }
+    }
+
+    int32_t SendStream(int32_t apiId, Request& request)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckCall(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        SetHeader(request.header(), apiId, leaseId, priority, true);
+
+        if (!GetTransport()->SendStream(request, 0))
+        {
+            return UT_ROBOT_ERR_CLIENT_SEND;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * Send chunks of parameter until api has run, result is the answer
+     * carrying first chunk of data. A failed chunk drops the window and
+     * sending goes on from bytes acknowledged by server, chunks arrived
+     * again are ignored by server.
+     */
+    int32_t WriteTransfer(TransferParameter& transfer, const std::vector<uint8_t>& parameter, int64_t leaseId,
+        TransferData& result, const TransferProgressCallback& progress)
+    {
+        std::deque<int64_t> window;
+        uint64_t offset = 0, received = 0, pollTime = 0;
+        int32_t retry = 0;
+
+        while (true)
+        {
+            while (offset < transfer.size && window.size() < UT_ROBOT_CLIENT_TRANSFER_WINDOW)
+            {
+                uint64_t len = std::min<uint64_t>(transfer.chunkSize, transfer.size - offset);
+
+                transfer.op = ROBOT_TRANSFER_OP_WRITE;
+                transfer.offset = offset;
+                transfer.chunk.assign(parameter.begin() + offset, parameter.begin() + offset + len);
+
+                window.push_back(SendTransfer(transfer, leaseId, false));
+                offset += len;
+            }
+
+            TransferData data;
+            int32_t ret = UT_ROBOT_OK;
+
+            if (window.empty())
+            {
+                transfer.op = ROBOT_TRANSFER_OP_QUERY;
+                transfer.chunk.clear();
+
+                ret = WaitTransfer(SendTransfer(transfer, leaseId, false), data);
+            }
+            else
+            {
+                ret = WaitTransfer(window.front(), data);
+                window.pop_front();
+            }
+
+            if (ret == UT_ROBOT_OK && data.done)
+            {
+                ReleaseTransfer(window);
+                result = std::move(data);
+
+                if (progress && received < transfer.size)
+                {
+                    progress(transfer.size, transfer.size);
+                }
+
+                return UT_ROBOT_OK;
+            }
+
+            if (ret == UT_ROBOT_OK)
+            {
+                if (data.received > received)
+                {
+                    received = data.received;
+                    retry = 0;
+
+                    if (progress)
+                    {
+                        progress(received, transfer.size);
+                    }
+                }
+
+                if (!window.empty() || offset < transfer.size)
+                {
+                    continue;
+                }
+
+                if (data.received < transfer.size)
+                {
+                    /*
+                     * all chunks answered but some not kept, e.g. server
+                     * dropped the transfer.
+                     */
+                    if (++retry > UT_ROBOT_CLIENT_TRANSFER_RETRY)
+                    {
+                        return UT_ROBOT_ERR_CLIENT_API_DATA;
+                    }
+
+                    offset = data.received;
+                    continue;
+                }
+
+                /*
+                 * all received, api is running.
+                 */
+                uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+                if (pollTime == 0)
+                {
+                    pollTime = now;
+                }
+                else if (now > pollTime + GetTimeout())
+                {
+                    return UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+                }
+
+                common::MicroSleep(UT_ROBOT_CLIENT_TRANSFER_POLL_MICROSEC);
+                continue;
+            }
+
+            ReleaseTransfer(window);
+
+            if (!IsTransferRetryable(ret) || ++retry > UT_ROBOT_CLIENT_TRANSFER_RETRY)
+            {
+                return ret;
+            }
+
+            if (ret == UT_ROBOT_ERR_SERVER_TRANSFER_NOT_EXIST)
+            {
+                received = 0;
+            }
+
+            offset = received;
+        }
+    }
+
+    /*
+     * Read data of api after the chunk carried by result.
+     */
+    int32_t ReadTransfer(TransferParameter& transfer, int64_t leaseId, const TransferData& result,
+        std::vector<uint8_t>& data)
+    {
+        data = result.chunk;
+        data.reserve(result.size);
+
+        int32_t retry = 0;
+
+        while (data.size() < result.size)
+        {
+            transfer.op = ROBOT_TRANSFER_OP_READ;
+            transfer.offset = data.size();
+            transfer.chunk.clear();
+
+            TransferData chunkData;
+
+            int32_t ret = WaitTransfer(SendTransfer(transfer, leaseId, false), chunkData);
+            if (ret == UT_ROBOT_OK && (!chunkData.done || chunkData.chunk.empty()))
+            {
+                ret = UT_ROBOT_ERR_CLIENT_API_DATA;
+            }
+
+            if (ret != UT_ROBOT_OK)
+            {
+                if (!IsTransferRetryable(ret) || ++retry > UT_ROBOT_CLIENT_TRANSFER_RETRY)
+                {
+                    return ret;
+                }
+
+                continue;
+            }
+
+            data.insert(data.end(), chunkData.chunk.begin(), chunkData.chunk.end());
+            retry = 0;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * return request id, or ROBOT_API_ID_NONE if failed.
+     */
+    int64_t SendTransfer(const TransferParameter& transfer, int64_t leaseId, bool noReply)
+    {
+        Request request;
+        SetHeader(request.header(), ROBOT_API_ID_TRANSFER, leaseId, 0, noReply);
+        common::EncodeBinary(transfer, request.binary());
+
+        ClientTransport* transport = GetTransport();
+
+        int64_t requestId = transport->Send(request, GetTimeout(), noReply ? 0 : GetTimeout());
+        if (noReply && requestId != ROBOT_API_ID_NONE)
+        {
+            transport->Release(requestId);
+        }
+
+        return requestId;
+    }
+
+    int32_t WaitTransfer(int64_t requestId, TransferData& data)
+    {
+        if (requestId == ROBOT_API_ID_NONE)
+        {
+            return UT_ROBOT_ERR_CLIENT_SEND;
+        }
+
+        ClientTransport* transport = GetTransport();
+
+        int32_t ret = UT_ROBOT_OK;
+
+        const Response* response = transport->Wait(requestId, GetTimeout());
+        if (response == NULL)
+        {
+            ret = UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+        }
+        else if (response->header().identity().api_id() != ROBOT_API_ID_TRANSFER)
+        {
+            ret = UT_ROBOT_ERR_CLIENT_API_NOT_MATCH;
+        }
+        else
+        {
+            ret = response->header().status().code();
+            if (ret == UT_ROBOT_OK && !common::DecodeBinary(response->binary(), data))
+            {
+                ret = UT_ROBOT_ERR_CLIENT_API_DATA;
+            }
+        }
+
+        transport->Release(requestId);
+
+        return ret;
+    }
+
+    /*
+     * Give up chunks in flight, their answers are dropped.
+     */
+    void ReleaseTransfer(std::deque<int64_t>& window)
+    {
+        for (int64_t requestId : window)
+        {
+            if (requestId != ROBOT_API_ID_NONE)
+            {
+                GetTransport()->Release(requestId);
+            }
+        }
+
+        window.clear();
+    }
+
+    static bool IsTransferRetryable(int32_t code)
+    {
+        return code == UT_ROBOT_ERR_CLIENT_SEND || code == UT_ROBOT_ERR_CLIENT_API_TIMEOUT ||
+            code == UT_ROBOT_ERR_SERVER_API_EXPIRED || code == UT_ROBOT_ERR_SERVER_TRANSFER_NOT_EXIST;
+    }
+
+    /*
+     * Transfer id unique among clients of server, by route tag of transport
+     * in the high half and a counter of process in the low half.
+     */
+    int64_t NewTransferId()
+    {
+        static std::atomic<uint32_t> counter(0);
+
+        uint32_t sequence = ++counter;
+        if (sequence == 0)
+        {
+            sequence = ++counter;
+        }
+
+        return (int64_t)(((uint64_t)GetTransport()->GetTag() << 32) | sequence) & INT64_MAX;
+    }
+
+    /*
+     * mTransportPtr is set before mTransport, and read only after it.
+     */
+    ClientTransport* GetTransport()
+    {
+        ClientTransport* transport = mTransport.load(std::memory_order_acquire);
+        if (transport == NULL)
+        {
+            common::LockGuard<common::Mutex> guard(mTransportMutex);
+            if (!mTransportPtr)
+            {
+                mTransportPtr = ClientTransport::Get(mName);
+            }
+
+            transport = mTransportPtr.get();
+            mTransport.store(transport, std::memory_order_release);
+        }
+
+        return transport;
+    }
+
+    /*
+     * wait false never blocks on negotiation, apiId goes by json until
+     * server api version is known.
+     */
+    bool IsBinaryApi(int32_t apiId, bool wait = true)
+    {
+        return mBinaryApiSet.find(apiId) != mBinaryApiSet.end() && (wait ? Negotiate() : NegotiateAsync()) &&
+            mServerCodec.load() == ROBOT_API_CODEC_BINARY;
+    }
+
+    /*
+     * Negotiate on a thread of its own for callers which must not block,
+     * e.g. stream. return true if server api version is known.
+     */
+    bool NegotiateAsync()
+    {
+        if (mServerCodec.load() != ROBOT_API_CODEC_UNKNOWN)
+        {
+            return true;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        uint64_t lastTime = mNegotiateTime.load();
+
+        if ((lastTime > 0 && now < lastTime + UT_ROBOT_CODEC_NEGOTIATE_INTERVAL) || mNegotiating.exchange(true))
+        {
+            return false;
+        }
+
+        common::LockGuard<common::Mutex> guard(mNegotiateThreadMutex);
+        if (mNegotiateThreadPtr)
+        {
+            //finished, mNegotiating was false
+            mNegotiateThreadPtr->Wait();
+        }
+
+        mNegotiateThreadPtr = common::CreateThreadEx("clinego", UT_CPU_ID_NONE, &CodecClient::NegotiateThreadFunction, this);
+
+        return false;
+    }
+
+    int32_t NegotiateThreadFunction()
+    {
+        Negotiate();
+        mNegotiating.store(false);
+
+        return 0;
+    }
+
+    /*
+     * Ask server api version once, a failed query is retried after
+     * UT_ROBOT_CODEC_NEGOTIATE_INTERVAL and calls use json meanwhile.
+     * return true if server api version is known.
+     */
+    bool Negotiate()
+    {
+        if (mServerCodec.load() != ROBOT_API_CODEC_UNKNOWN)
+        {
+            return true;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        uint64_t lastTime = mNegotiateTime.load();
+
+        if ((lastTime > 0 && now < lastTime + UT_ROBOT_CODEC_NEGOTIATE_INTERVAL) ||
+            !mNegotiateTime.compare_exchange_strong(lastTime, now))
+        {
+            return false;
+        }
+
+        std::string version = GetServerApiVersion();
+        if (version.empty())
+        {
+            return false;
+        }
+
+        if (mLeasePtr)
+        {
+            mLeasePtr->SetServerRenewal(version.find(ROBOT_API_VERSION_RENEWAL_TAG) != std::string::npos);
+        }
+
+        mServerTransfer.store(version.find(ROBOT_API_VERSION_TRANSFER_TAG) != std::string::npos);
+
+        int32_t codec = (version.find(ROBOT_API_VERSION_BINARY_TAG) != std::string::npos) ?
+            ROBOT_API_CODEC_BINARY : ROBOT_API_CODEC_JSON;
+        mServerCodec.store(codec);
+
+        return true;
+    }
+
+    /*
+     * Server lost binary apis, e.g. restarted as an older version.
+     */
+    void ResetNegotiation()
+    {
+        mNegotiateTime.store(common::GetCurrentMonotonicTimeMicrosecond());
+        mServerCodec.store(ROBOT_API_CODEC_UNKNOWN);
+    }
+
+private:
+    static const int32_t ROBOT_API_CODEC_UNKNOWN = -1;
+
+    std::string mName;
+    std::atomic<ClientTransport*> mTransport;
+    common::Mutex mTransportMutex;
+    ClientTransportPtr mTransportPtr;
+
+    std::atomic<int32_t> mServerCodec;
+    std::atomic<uint64_t> mNegotiateTime;
+    std::atomic<bool> mNegotiating;
+    common::Mutex mNegotiateThreadMutex;
+    common::ThreadPtr mNegotiateThreadPtr;
+    std::atomic<bool> mBatchUnsupported;
+    std::atomic<bool> mServerTransfer;
+    std::set<int32_t> mBinaryApiSet;
+
+    SharedLeasePtr mLeasePtr;
+    ServiceLatency* mLatency;
+};
+
+using CodecClientPtr = std::shared_ptr<CodecClient>;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_CODEC_CLIENT_HPP__
@@ -0,0 +1,355 @@
+#ifndef __UT_ROBOT_SDK_LEASE_MANAGER_HPP__
+#define __UT_ROBOT_SDK_LEASE_MANAGER_HPP__
+
+#include <unitree/common/os.hpp>
+#include <unitree/common/thread/thread.hpp>
+#include <unitree/robot/client/client_base.hpp>
+
+/*
+ * longest wait of lease manager between checks of its leases, and wait
+ * before applying or renewing again after a failed try.
+ */
+#define UT_ROBOT_LEASE_MANAGER_WAIT_MICROSEC   100000
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * @class: SharedLease
+ *         Lease of one service shared by leased CodecClients of the service
+ *         in process. It is applied and renewed by LeaseManager, and renewed
+ *         by calls of its clients if server renews lease of requests.
+ *         Client keeps the lease client of the lib, leased clients not
+ *         derived from CodecClient each hold a lease of their own.
+ */
+class SharedLease : public ClientBase
+{
+public:
+    explicit SharedLease(const std::string& name) :
+        ClientBase(name), mId(0), mTerm(0), mRefreshTime(0), mServerRenewal(false),
+        mSendTime(0), mRetryTime(0)
+    {
+        common::OsHelper* os = common::OsHelper::Instance();
+        mContextName = os->GetHostname() + ":" + std::to_string(os->GetProcessId());
+    }
+
+    void Init()
+    {}
+
+    /*
+     * Lease id, 0 if lease is not applied or expired.
+     */
+    int64_t GetId() const
+    {
+        int64_t id = mId.load();
+        if (id == 0 || common::GetCurrentMonotonicTimeMicrosecond() >= mRefreshTime.load() + mTerm.load())
+        {
+            return 0;
+        }
+
+        return id;
+    }
+
+    bool Applied() const
+    {
+        return GetId() != 0;
+    }
+
+    /*
+     * Wait at most microsec for lease applied. return UT_ROBOT_OK, or
+     * UT_ROBOT_ERR_CLIENT_API_TIMEOUT if it is not, e.g. server is down.
+     */
+    int32_t WaitApplied(int64_t microsec)
+    {
+        uint64_t deadline = common::GetCurrentMonotonicTimeMicrosecond() + microsec;
+
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+        while (!Applied())
+        {
+            uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+            if (now >= deadline)
+            {
+                return UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+            }
+
+            mMutexCond.Wait(std::min<int64_t>(deadline - now, UT_ROBOT_LEASE_MANAGER_WAIT_MICROSEC));
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    void SetServerRenewal(bool serverRenewal)
+    {
+        mServerRenewal = serverRenewal;
+    }
+
+    /*
+     * A request carrying lease id and sent at sendTime was answered. Server
+     * renews lease at most once a ROBOT_LEASE_RENEWAL_INTERVAL, so the
+     * renewal is counted from that long before sending.
+     */
+    void Refresh(int64_t id, uint64_t sendTime)
+    {
+        if (!mServerRenewal || id != mId.load() || sendTime < (uint64_t)ROBOT_LEASE_RENEWAL_INTERVAL)
+        {
+            return;
+        }
+
+        Advance(sendTime - ROBOT_LEASE_RENEWAL_INTERVAL);
+    }
+
+    /*
+     * Request carrying lease id was denied by server, apply again.
+     */
+    void Reset(int64_t id)
+    {
+        mId.compare_exchange_strong(id, 0);
+    }
+
+private:
+    friend class LeaseManager;
+
+    void Advance(uint64_t refreshTime)
+    {
+        uint64_t lastTime = mRefreshTime.load();
+        while (refreshTime > lastTime && !mRefreshTime.compare_exchange_weak(lastTime, refreshTime))
+        {}
+    }
+
+    /*
+     * Time of next apply or renewal, called by LeaseManager only.
+     */
+    uint64_t GetDueTime() const
+    {
+        uint64_t dueTime = 0;
+        if (mId.load() != 0)
+        {
+            dueTime = mRefreshTime.load() + mTerm.load() / 3;
+        }
+
+        return std::max(dueTime, mRetryTime);
+    }
+
+    ClientFuturePtr Send()
+    {
+        mSendTime = common::GetCurrentMonotonicTimeMicrosecond();
+
+        int64_t id = mId.load();
+        if (id == 0)
+        {
+            ApplyLeaseParameter parameter;
+            parameter.name = mContextName;
+
+            return CallAsync(ROBOT_API_ID_LEASE_APPLY, common::ToJsonString(parameter), 0, 0);
+        }
+
+        return CallAsync(ROBOT_API_ID_LEASE_RENEWAL, "", 0, id);
+    }
+
+    void Receive(const ClientFuturePtr& futurePtr)
+    {
+        std::string data;
+        int32_t code = futurePtr->Get(data);
+
+        int64_t id = mId.load();
+        mRetryTime = 0;
+
+        if (id == 0)
+        {
+            ApplyLeaseData leaseData;
+
+            try
+            {
+                if (code == UT_ROBOT_OK)
+                {
+                    common::FromJsonString(data, leaseData);
+                }
+            }
+            catch (const common::Exception&)
+            {
+                code = UT_ROBOT_ERR_CLIENT_API_DATA;
+            }
+
+            if (code != UT_ROBOT_OK || leaseData.id == 0)
+            {
+                mRetryTime = mSendTime + UT_ROBOT_LEASE_MANAGER_WAIT_MICROSEC;
+                return;
+            }
+
+            common::LockGuard<common::MutexCond> guard(mMutexCond);
+            mTerm = (leaseData.term > 0) ? leaseData.term : ROBOT_LEASE_TERM;
+            mRefreshTime = mSendTime;
+            mId = leaseData.id;
+            mMutexCond.NotifyAll();
+        }
+        else if (code == UT_ROBOT_OK)
+        {
+            Advance(mSendTime);
+        }
+        else if (code == UT_ROBOT_ERR_SERVER_LEASE_DENIED || code == UT_ROBOT_ERR_SERVER_LEASE_NOT_EXIST ||
+            GetId() == 0)
+        {
+            Reset(id);
+        }
+        else
+        {
+            mRetryTime = common::GetCurrentMonotonicTimeMicrosecond() + UT_ROBOT_LEASE_MANAGER_WAIT_MICROSEC;
+        }
+    }
+
+private:
+    std::string mContextName;
+
+    std::atomic<int64_t> mId;
+    std::atomic<int64_t> mTerm;
+    std::atomic<uint64_t> mRefreshTime;
+    std::atomic<bool> mServerRenewal;
+
+    //used by LeaseManager thread only
+    uint64_t mSendTime;
+    uint64_t mRetryTime;
+
+    common::MutexCond mMutexCond;
+};
+
+using SharedLeasePtr = std::shared_ptr<SharedLease>;
+
+/*
+ * @brief
+ * @class: LeaseManager
+ *         Applies and renews shared leases of CodecClients in process from
+ *         one thread. Renewals of due leases are sent together and a lease is
+ *         not renewed while calls of its clients keep it fresh.
+ */
+class LeaseManager
+{
+public:
+    static LeaseManager* Instance()
+    {
+        static LeaseManager inst;
+        return &inst;
+    }
+
+    ~LeaseManager()
+    {
+        {
+            common::LockGuard<common::MutexCond> guard(mMutexCond);
+            mQuit = true;
+            mMutexCond.NotifyAll();
+        }
+
+        if (mThreadPtr)
+        {
+            mThreadPtr->Wait();
+        }
+    }
+
+    /*
+     * Lease of service, kept while any client holds it.
+     */
+    SharedLeasePtr Get(const std::string& name)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        std::weak_ptr<SharedLease>& weakPtr = mLeaseMap[name];
+
+        SharedLeasePtr leasePtr = weakPtr.lock();
+        if (!leasePtr)
+        {
+            leasePtr.reset(new SharedLease(name));
+            weakPtr = leasePtr;
+        }
+
+        if (!mThreadPtr)
+        {
+            mThreadPtr = common::CreateThreadEx("leasemgr", UT_CPU_ID_NONE, &LeaseManager::ThreadFunction, this);
+        }
+
+        mMutexCond.Notify();
+
+        return leasePtr;
+    }
+
+private:
+    LeaseManager() :
+        mQuit(false)
+    {}
+
+    int32_t ThreadFunction()
+    {
+        while (true)
+        {
+            std::vector<SharedLeasePtr> dueList;
+
+            {
+                common::LockGuard<common::MutexCond> guard(mMutexCond);
+                if (mQuit)
+                {
+                    break;
+                }
+
+                uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+                uint64_t waitTime = UT_ROBOT_LEASE_MANAGER_WAIT_MICROSEC;
+
+                auto iter = mLeaseMap.begin();
+                while (iter != mLeaseMap.end())
+                {
+                    SharedLeasePtr leasePtr = iter->second.lock();
+                    if (!leasePtr)
+                    {
+                        iter = mLeaseMap.erase(iter);
+                        continue;
+                    }
+
+                    uint64_t dueTime = leasePtr->GetDueTime();
+                    if (dueTime <= now)
+                    {
+                        dueList.push_back(leasePtr);
+                    }
+                    else if (dueTime - now < waitTime)
+                    {
+                        waitTime = dueTime - now;
+                    }
+
+                    ++iter;
+                }
+
+                if (dueList.empty())
+                {
+                    mMutexCond.Wait(waitTime);
+                    continue;
+                }
+            }
+
+            /*
+             * send all before waiting any, one slow server does not hold
+             * renewals of the others.
+             */
+            std::vector<ClientFuturePtr> futureList;
+            for (const SharedLeasePtr& leasePtr : dueList)
+            {
+                futureList.push_back(leasePtr->Send());
+            }
+
+            for (size_t i=0; i<dueList.size(); i++)
+            {
+                dueList[i]->Receive(futureList[i]);
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    bool mQuit;
+    common::MutexCond mMutexCond;
+    std::map<std::string,std::weak_ptr<SharedLease>> mLeaseMap;
+    common::ThreadPtr mThreadPtr;
+};
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_LEASE_MANAGER_HPP__
@@ -0,0 +1,438 @@
+#ifndef __UT_ROBOT_SDK_REQUEST_SLOT_TABLE_HPP__
+#define __UT_ROBOT_SDK_REQUEST_SLOT_TABLE_HPP__
+
+#include <set>
+#include <random>
+#include <fstream>
+#include <unitree/common/os.hpp>
+#include <unitree/common/exception.hpp>
+#include <unitree/common/lock/futex.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/robot/internal/internal.hpp>
+
+/*
+ * default pending requests of one slot table.
+ */
+#define UT_ROBOT_REQUEST_SLOT_TABLE_CAPACITY    1024
+
+/*
+ * request id of slot table:
+ *   flag | 30 bits table tag | 12 bits budget | 20 bits sequence.
+ * budget is how long server may keep request before dispatch, in units of
+ * UT_ROBOT_REQUEST_BUDGET_UNIT microseconds, 0 for no deadline.
+ */
+#define UT_ROBOT_REQUEST_SLOT_ID_FLAG           0x4000000000000000LL
+#define UT_ROBOT_REQUEST_SLOT_TAG_MASK          0x3FFFFFFF
+#define UT_ROBOT_REQUEST_SLOT_SEQUENCE_MASK     0xFFFFF
+#define UT_ROBOT_REQUEST_SLOT_BUDGET_SHIFT      20
+#define UT_ROBOT_REQUEST_SLOT_BUDGET_MASK       0xFFF
+#define UT_ROBOT_REQUEST_BUDGET_UNIT            10000
+
+/*
+ * table tag: 8 bits counter of process | 22 bits process id, xor key of
+ * host boot. Linux process ids are below 2^22.
+ */
+#define UT_ROBOT_REQUEST_TAG_PID_BITS           22
+#define UT_ROBOT_REQUEST_TAG_PID_MASK           0x3FFFFF
+#define UT_ROBOT_REQUEST_TAG_COUNTER_MASK       0xFF
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * @class: RequestTagRegistry
+ *         Tags of slot tables in process. Process id and a counter of
+ *         process fill the 30 tag bits, so tables of one host never share
+ *         a tag. The host part is xor a key of host name and boot id, and
+ *         tables of two hosts share a tag by chance of 2^-30 per pair. A
+ *         tag still in use in process is rejected and the next one tried.
+ */
+class RequestTagRegistry
+{
+public:
+    /*
+     * Never destroyed, slot tables are released by static destructors too.
+     */
+    static RequestTagRegistry* Instance()
+    {
+        static RequestTagRegistry* inst = new RequestTagRegistry();
+        return inst;
+    }
+
+    uint32_t Acquire()
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+
+        uint32_t pid = common::OsHelper::Instance()->GetProcessId() & UT_ROBOT_REQUEST_TAG_PID_MASK;
+
+        for (uint32_t i=0; i<=UT_ROBOT_REQUEST_TAG_COUNTER_MASK; i++)
+        {
+            uint32_t counter = (mCounter++) & UT_ROBOT_REQUEST_TAG_COUNTER_MASK;
+            uint32_t tag = ((counter << UT_ROBOT_REQUEST_TAG_PID_BITS) | pid) ^ mHostKey;
+
+            if (mTagSet.insert(tag).second)
+            {
+                return tag;
+            }
+        }
+
+        UT_THROW(common::CommonException, "request slot table tags of process are used up");
+    }
+
+    void Release(uint32_t tag)
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+        mTagSet.erase(tag);
+    }
+
+private:
+    RequestTagRegistry() :
+        mCounter(0)
+    {
+        mHostKey = GetHostKey();
+    }
+
+    /*
+     * boot id differs on hosts cloned from one image, random if missing.
+     */
+    static uint32_t GetHostKey()
+    {
+        std::string bootId;
+
+        std::ifstream file("/proc/sys/kernel/random/boot_id");
+        if (!std::getline(file, bootId) || bootId.empty())
+        {
+            std::random_device rd;
+            bootId = std::to_string(rd());
+        }
+
+        std::string key = common::OsHelper::Instance()->GetHostname() + ":" + bootId;
+
+        //FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : key)
+        {
+            hash = (hash ^ (uint8_t)c) * 1099511628211ULL;
+        }
+
+        return (uint32_t)(hash ^ (hash >> 30) ^ (hash >> 60)) & UT_ROBOT_REQUEST_SLOT_TAG_MASK;
+    }
+
+private:
+    common::Mutex mMutex;
+    uint32_t mCounter;
+    uint32_t mHostKey;
+    std::set<uint32_t> mTagSet;
+};
+
+/*
+ * @brief
+ * @class: RequestSlotTable
+ *         Fixed capacity table of pending requests, indexed by sequence of
+ *         request id. Slots and their responses are reused, a call takes
+ *         and releases a slot by atomic state and waits on it by futex.
+ */
+class RequestSlotTable
+{
+public:
+    enum
+    {
+        FREE = 0,
+        PENDING = 1,
+        BUSY = 2,
+        READY = 3
+    };
+
+    explicit RequestSlotTable(uint32_t capacity = UT_ROBOT_REQUEST_SLOT_TABLE_CAPACITY) :
+        mSequence(0)
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        {
+            UT_THROW(common::CommonException, "request slot table capacity is not power of 2");
+        }
+
+        if (capacity > UT_ROBOT_REQUEST_SLOT_SEQUENCE_MASK + 1)
+        {
+            UT_THROW(common::CommonException, "request slot table capacity is out of sequence range");
+        }
+
+        mMask = capacity - 1;
+        mSlots.reset(new Slot[capacity]);
+
+        /*
+         * tag names the route channel of table and keeps its ids apart from
+         * tables of other processes and hosts.
+         */
+        mTag = RequestTagRegistry::Instance()->Acquire();
+        mIdBase = UT_ROBOT_REQUEST_SLOT_ID_FLAG | ((int64_t)mTag << 32);
+    }
+
+    ~RequestSlotTable()
+    {
+        RequestTagRegistry::Instance()->Release(mTag);
+    }
+
+    /*
+     * Tag of request id, false if id is not from a slot table.
+     */
+    static bool GetRequestTag(int64_t requestId, uint32_t& tag)
+    {
+        if (requestId < 0 || (requestId & UT_ROBOT_REQUEST_SLOT_ID_FLAG) == 0)
+        {
+            return false;
+        }
+
+        tag = (uint32_t)(requestId >> 32) & UT_ROBOT_REQUEST_SLOT_TAG_MASK;
+        return true;
+    }
+
+    /*
+     * Budget of request id in microseconds, 0 if request has no deadline.
+     */
+    static int64_t GetRequestBudget(int64_t requestId)
+    {
+        uint32_t tag = 0;
+        if (!GetRequestTag(requestId, tag))
+        {
+            return 0;
+        }
+
+        return (int64_t)((requestId >> UT_ROBOT_REQUEST_SLOT_BUDGET_SHIFT) & UT_ROBOT_REQUEST_SLOT_BUDGET_MASK) *
+            UT_ROBOT_REQUEST_BUDGET_UNIT;
+    }
+
+    static uint32_t GetRequestSequence(int64_t requestId)
+    {
+        return (uint32_t)requestId & UT_ROBOT_REQUEST_SLOT_SEQUENCE_MASK;
+    }
+
+    /*
+     * Distance from sequence 'from' to 'to', negative if 'to' is older.
+     */
+    static int32_t GetSequenceDelta(uint32_t from, uint32_t to)
+    {
+        const uint32_t shift = 32 - UT_ROBOT_REQUEST_SLOT_BUDGET_SHIFT;
+        return (int32_t)((to - from) << shift) >> shift;
+    }
+
+    /*
+     * Take a free slot, return request id or ROBOT_API_ID_NONE if all slots
+     * are pending. budget > 0 is carried in request id, rounded up to units.
+     * A budget over the largest one is carried as no deadline.
+     */
+    int64_t Acquire(int64_t budget = 0)
+    {
+        for (uint32_t i=0; i<=mMask; i++)
+        {
+            uint32_t sequence = mSequence.fetch_add(1, std::memory_order_relaxed);
+            Slot& slot = mSlots[sequence & mMask];
+
+            uint32_t state = FREE;
+            if (slot.mState.compare_exchange_strong(state, BUSY, std::memory_order_acquire))
+            {
+                int64_t requestId = GetRequestId(sequence) | EncodeBudget(budget);
+                slot.mRequestId = requestId;
+                slot.mState.store(PENDING, std::memory_order_release);
+
+                return requestId;
+            }
+        }
+
+        return ROBOT_API_ID_NONE;
+    }
+
+    /*
+     * Called by response thread, false if no request waits for response.
+     */
+    bool Ready(const Response& response)
+    {
+        int64_t requestId = response.header().identity().id();
+
+        Slot* slot = GetSlot(requestId);
+        if (slot == NULL)
+        {
+            return false;
+        }
+
+        uint32_t state = PENDING;
+        if (!slot->mState.compare_exchange_strong(state, BUSY, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        if (slot->mRequestId != requestId)
+        {
+            slot->mState.store(PENDING, std::memory_order_release);
+            common::Futex::Wake(slot->mState);
+            return false;
+        }
+
+        slot->mResponse = response;
+        slot->mReadyTime = common::GetCurrentMonotonicTimeMicrosecond();
+        slot->mState.store(READY, std::memory_order_release);
+        common::Futex::Wake(slot->mState);
+
+        return true;
+    }
+
+    /*
+     * Wait response of request, the response is valid until Release.
+     * return NULL on timeout.
+     */
+    const Response* Wait(int64_t requestId, int64_t microsec)
+    {
+        Slot* slot = GetSlot(requestId);
+        if (slot == NULL)
+        {
+            return NULL;
+        }
+
+        uint64_t deadline = common::GetCurrentMonotonicTimeMicrosecond() + microsec;
+
+        while (true)
+        {
+            uint32_t state = slot->mState.load(std::memory_order_acquire);
+            if (state == READY)
+            {
+                return &slot->mResponse;
+            }
+
+            uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+            if (now >= deadline)
+            {
+                return NULL;
+            }
+
+            common::Futex::Wait(slot->mState, state, deadline - now);
+        }
+    }
+
+    /*
+     * Whether response of request is in, without waiting.
+     */
+    bool IsReady(int64_t requestId)
+    {
+        Slot* slot = GetSlot(requestId);
+        return slot != NULL && slot->mState.load(std::memory_order_acquire) == READY;
+    }
+
+    /*
+     * Give back slot of request, whether response arrived or not.
+     */
+    void Release(int64_t requestId)
+    {
+        Slot* slot = GetSlot(requestId);
+        if (slot == NULL)
+        {
+            return;
+        }
+
+        while (true)
+        {
+            uint32_t state = slot->mState.load(std::memory_order_acquire);
+            if (state == BUSY)
+            {
+                //response thread holds the slot for a copy
+                sched_yield();
+                continue;
+            }
+
+            if (slot->mState.compare_exchange_weak(state, BUSY, std::memory_order_acquire))
+            {
+                break;
+            }
+        }
+
+        slot->mRequestId = 0;
+        slot->mState.store(FREE, std::memory_order_release);
+    }
+
+    /*
+     * Monotonic time response of request arrived, valid after Wait returned
+     * it and until Release.
+     */
+    uint64_t GetReadyTime(int64_t requestId)
+    {
+        Slot* slot = GetSlot(requestId);
+        return (slot == NULL) ? 0 : slot->mReadyTime;
+    }
+
+    uint32_t GetCapacity() const
+    {
+        return mMask + 1;
+    }
+
+    uint32_t GetTag() const
+    {
+        return mTag;
+    }
+
+    /*
+     * Request id of sequence, for requests not waiting response.
+     */
+    int64_t GetRequestId(uint32_t sequence) const
+    {
+        return mIdBase | (sequence & UT_ROBOT_REQUEST_SLOT_SEQUENCE_MASK);
+    }
+
+    bool IsOwner(int64_t requestId) const
+    {
+        return (requestId & ~(int64_t)UINT32_MAX) == mIdBase;
+    }
+
+private:
+    struct Slot
+    {
+        Slot() :
+            mState(FREE), mRequestId(0), mReadyTime(0)
+        {}
+
+        std::atomic<uint32_t> mState;
+        int64_t mRequestId;
+        uint64_t mReadyTime;
+        Response mResponse;
+    };
+
+    static int64_t EncodeBudget(int64_t budget)
+    {
+        if (budget <= 0)
+        {
+            return 0;
+        }
+
+        int64_t units = (budget + UT_ROBOT_REQUEST_BUDGET_UNIT - 1) / UT_ROBOT_REQUEST_BUDGET_UNIT;
+        if (units > UT_ROBOT_REQUEST_SLOT_BUDGET_MASK)
+        {
+            //a shorter budget would drop calls still waited for
+            return 0;
+        }
+
+        return units << UT_ROBOT_REQUEST_SLOT_BUDGET_SHIFT;
+    }
+
+    Slot* GetSlot(int64_t requestId)
+    {
+        if (!IsOwner(requestId))
+        {
+            return NULL;
+        }
+
+        return &mSlots[GetRequestSequence(requestId) & mMask];
+    }
+
+private:
+    uint32_t mMask;
+    uint32_t mTag;
+    int64_t mIdBase;
+    std::atomic<uint32_t> mSequence;
+    std::unique_ptr<Slot[]> mSlots;
+};
+
+using RequestSlotTablePtr = std::shared_ptr<RequestSlotTable>;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_REQUEST_SLOT_TABLE_HPP__
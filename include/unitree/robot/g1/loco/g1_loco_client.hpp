@@ -104,6 +104,20 @@ class LocoClient : public Client {
     return ret;
   }
 
+  /*Async getters, callback runs on the async callback thread with code and
+    value of call, value is 0 if call failed.*/
+  void GetFsmIdAsync(const std::function<void(int32_t, int)>& callback) {
+    GetAsync<go2::JsonizeDataInt, int>(ROBOT_API_ID_LOCO_GET_FSM_ID, callback);
+  }
+
+  void GetBalanceModeAsync(const std::function<void(int32_t, int)>& callback) {
+    GetAsync<go2::JsonizeDataInt, int>(ROBOT_API_ID_LOCO_GET_BALANCE_MODE, callback);
+  }
+
+  void GetStandHeightAsync(const std::function<void(int32_t, float)>& callback) {
+    GetAsync<go2::JsonizeDataFloat, float>(ROBOT_API_ID_LOCO_GET_STAND_HEIGHT, callback);
+  }
+
   int32_t GetPhase(std::vector<float>& phase) {
     std::string parameter, data;
 
@@ -243,6 +257,23 @@ class LocoClient : public Client {
   }
 
 private:
+  template <typename JSON, typename T>
+  void GetAsync(int32_t apiId, const std::function<void(int32_t, T)>& callback) {
+    CallAsync(apiId, "", [callback](int32_t code, const std::string& data) {
+      JSON json;
+
+      if (code == 0) {
+        try {
+          common::FromJsonString(data, json);
+        } catch (const common::Exception&) {
+          code = UT_ROBOT_ERR_CLIENT_API_DATA;
+        }
+      }
+
+      callback(code, json.data);
+    });
+  }
+
   bool continous_move_ = false;
   bool first_shake_hand_stage_ = true;
 };
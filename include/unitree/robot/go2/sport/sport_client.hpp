@@ -27,6 +27,9 @@ typedef struct stPathPoint PathPoint;
 
 /*
  * SportClient
+ * Calls go by ClientStub of the lib, every response of sport service is
+ * decoded by every SportClient. Responses are routed per client only for
+ * CodecClient, see ClientTransport.
  */
 class SportClient : public Client
 {
@@ -0,0 +1,213 @@
+#ifndef __UT_ROBOT_SDK_API_LATENCY_HPP__
+#define __UT_ROBOT_SDK_API_LATENCY_HPP__
+
+#include <unitree/common/lock/lock.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <unitree/common/time/latency_histogram.hpp>
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief  Stages of an api call.
+ *         CLIENT_SEND:     client writing request.
+ *         CLIENT_WAIT:     request sent to response arrived at client.
+ *         CLIENT_DELIVERY: response arrived to calling thread woken.
+ *         SERVER_QUEUE:    request received to a worker taking it.
+ *         SERVER_HANDLER:  handler running.
+ *         SERVER_REPLY:    server writing response.
+ */
+const int32_t ROBOT_API_LATENCY_CLIENT_SEND         = 0;
+const int32_t ROBOT_API_LATENCY_CLIENT_WAIT         = 1;
+const int32_t ROBOT_API_LATENCY_CLIENT_DELIVERY     = 2;
+const int32_t ROBOT_API_LATENCY_SERVER_QUEUE        = 3;
+const int32_t ROBOT_API_LATENCY_SERVER_HANDLER      = 4;
+const int32_t ROBOT_API_LATENCY_SERVER_REPLY        = 5;
+const int32_t ROBOT_API_LATENCY_STAGE_COUNT         = 6;
+
+/*
+ * @brief
+ * @class: ServiceLatency
+ *         Latency histograms of apis of one service in process. Apis are
+ *         found in a read-only index without lock, the index is copied
+ *         under mMutex only when an api is recorded first time.
+ */
+class ServiceLatency
+{
+public:
+    ServiceLatency() :
+        mApiIndex(NULL)
+    {}
+
+    void Record(int32_t apiId, int32_t stage, uint64_t microsec)
+    {
+        GetApi(apiId).mHistograms[stage].Record(microsec);
+    }
+
+    /*
+     * Record time since startTime, return now.
+     */
+    uint64_t RecordSince(int32_t apiId, int32_t stage, uint64_t startTime)
+    {
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        Record(apiId, stage, now > startTime ? now - startTime : 0);
+
+        return now;
+    }
+
+    /*
+     * {"<apiId>": {"<stage>": histogram}}, stages not recorded are left out.
+     */
+    void toJson(common::JsonMap& json)
+    {
+        static const char* stageNames[ROBOT_API_LATENCY_STAGE_COUNT] =
+        {
+            "send", "wait", "delivery", "queue", "handler", "reply"
+        };
+
+        common::LockGuard<common::Mutex> guard(mMutex);
+
+        for (auto& pair : mApiMap)
+        {
+            common::JsonMap apiJson;
+
+            for (int32_t stage=0; stage<ROBOT_API_LATENCY_STAGE_COUNT; stage++)
+            {
+                const common::LatencyHistogram& histogram = pair.second->mHistograms[stage];
+                if (histogram.GetCount() > 0)
+                {
+                    common::JsonMap histogramJson;
+                    histogram.toJson(histogramJson);
+                    apiJson[stageNames[stage]] = common::Any(histogramJson);
+                }
+            }
+
+            json[std::to_string(pair.first)] = common::Any(apiJson);
+        }
+    }
+
+private:
+    struct Api
+    {
+        common::LatencyHistogram mHistograms[ROBOT_API_LATENCY_STAGE_COUNT];
+    };
+
+    using ApiIndex = std::map<int32_t,Api*>;
+
+    Api& GetApi(int32_t apiId)
+    {
+        const ApiIndex* index = mApiIndex.load(std::memory_order_acquire);
+        if (index != NULL)
+        {
+            auto iter = index->find(apiId);
+            if (iter != index->end())
+            {
+                return *iter->second;
+            }
+        }
+
+        return AddApi(apiId);
+    }
+
+    Api& AddApi(int32_t apiId)
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+
+        std::unique_ptr<Api>& apiPtr = mApiMap[apiId];
+        if (apiPtr)
+        {
+            return *apiPtr;
+        }
+
+        apiPtr.reset(new Api());
+
+        /*
+         * index replaced may still be read, kept for the life of service.
+         * Apis of a service are few, so are copies.
+         */
+        std::unique_ptr<ApiIndex> indexPtr(new ApiIndex());
+        for (auto& pair : mApiMap)
+        {
+            (*indexPtr)[pair.first] = pair.second.get();
+        }
+
+        mApiIndex.store(indexPtr.get(), std::memory_order_release);
+        mApiIndexList.push_back(std::move(indexPtr));
+
+        return *apiPtr;
+    }
+
+private:
+    common::Mutex mMutex;
+    std::map<int32_t,std::unique_ptr<Api>> mApiMap;
+
+    std::atomic<const ApiIndex*> mApiIndex;
+    std::vector<std::unique_ptr<ApiIndex>> mApiIndexList;
+};
+
+/*
+ * @brief
+ * @class: ApiLatency
+ *         Latency of apis by service name, recorded by CodecClient and
+ *         DispatchServer of the process.
+ */
+class ApiLatency
+{
+public:
+    static ApiLatency* Instance()
+    {
+        static ApiLatency inst;
+        return &inst;
+    }
+
+    /*
+     * Latency of service, kept for the life of process.
+     */
+    ServiceLatency* Get(const std::string& name)
+    {
+        common::LockGuard<common::Mutex> guard(mMutex);
+
+        std::unique_ptr<ServiceLatency>& servicePtr = mServiceMap[name];
+        if (!servicePtr)
+        {
+            servicePtr.reset(new ServiceLatency());
+        }
+
+        return servicePtr.get();
+    }
+
+    /*
+     * {"<service>": {"<apiId>": {"<stage>": {"count", "mean", "p50", "p90",
+     * "p99", "p999", "max"}}}}, times in microseconds.
+     */
+    std::string Snapshot(bool pretty = false)
+    {
+        common::JsonMap json;
+
+        {
+            common::LockGuard<common::Mutex> guard(mMutex);
+            for (auto& pair : mServiceMap)
+            {
+                common::JsonMap serviceJson;
+                pair.second->toJson(serviceJson);
+                json[pair.first] = common::Any(serviceJson);
+            }
+        }
+
+        return common::ToJsonString(common::Any(json), pretty);
+    }
+
+private:
+    ApiLatency()
+    {}
+
+private:
+    common::Mutex mMutex;
+    std::map<std::string,std::unique_ptr<ServiceLatency>> mServiceMap;
+};
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_API_LATENCY_HPP__
@@ -3,6 +3,7 @@
 
 #include <unitree/common/decl.hpp>
 #include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/codec/binary_codec.hpp>
 
 namespace unitree
 {
@@ -44,6 +45,58 @@ const int32_t ROBOT_API_ID_LEASE_APPLY              = 101;
  */
 const int32_t ROBOT_API_ID_LEASE_RENEWAL            = 102;
 
+/*
+ * @brief  Run several apis in order by one request.
+ * @value: 103
+ */
+const int32_t ROBOT_API_ID_BATCH                    = 103;
+
+/*
+ * @brief  Chunk of a large binary parameter, run by binary api once all
+ *         chunks arrived.
+ * @value: 104
+ */
+const int32_t ROBOT_API_ID_TRANSFER                 = 104;
+
+/*
+ * @brief  Flag of api id carrying binary encoded parameter and data.
+ *         The binary form of api is registed as (apiId | flag).
+ * @value: 0x40000000
+ */
+const int32_t ROBOT_API_ID_BINARY_FLAG             = 0x40000000;
+
+///////////////////////////////////////////////////////////////
+
+/*
+ * @brief  Parameter codec of api: json, or binary with json fallback.
+ */
+const int32_t ROBOT_API_CODEC_JSON                  = 0;
+const int32_t ROBOT_API_CODEC_BINARY                = 1;
+
+/*
+ * @brief  Suffix of server api version if server accepts binary codec.
+ * @value: "+bin"
+ */
+#define ROBOT_API_VERSION_BINARY_TAG                "+bin"
+
+/*
+ * micro: ROBOT_API_BINARY_ID
+ */
+#define ROBOT_API_BINARY_ID(apiId) ((apiId) | ROBOT_API_ID_BINARY_FLAG)
+
+/*
+ * @brief  Suffix of server api version if server renews lease of requests
+ *         carrying a valid lease.
+ * @value: "+renew"
+ */
+#define ROBOT_API_VERSION_RENEWAL_TAG               "+renew"
+
+/*
+ * @brief  Suffix of server api version if server runs ROBOT_API_ID_TRANSFER.
+ * @value: "+xfer"
+ */
+#define ROBOT_API_VERSION_TRANSFER_TAG              "+xfer"
+
 ///////////////////////////////////////////////////////////////
 
 /*
@@ -52,6 +105,12 @@ const int32_t ROBOT_API_ID_LEASE_RENEWAL            = 102;
  */
 const int32_t ROBOT_LEASE_TERM                      = 1000000;
 
+/*
+ * @biref  least interval of server renewing a lease by its requests.
+ * @value: default 100000 us
+ */
+const int64_t ROBOT_LEASE_RENEWAL_INTERVAL          = 100000;
+
 /*
  * micro: IS_INTERNAL_API
  */
@@ -115,6 +174,140 @@ public:
     int64_t id;
     int64_t term;
 };
+
+/*
+ * @brief  One api call of ROBOT_API_ID_BATCH
+ * @class: BatchCall
+ */
+class BatchCall
+{
+public:
+    BatchCall() : apiId(0)
+    {}
+
+    BatchCall(int32_t apiId, const std::string& parameter, const std::vector<uint8_t>& binary = std::vector<uint8_t>()) :
+        apiId(apiId), parameter(parameter), binary(binary)
+    {}
+
+    UT_BINARY_CODEC(apiId, parameter, binary)
+
+public:
+    int32_t apiId;
+    std::string parameter;
+    std::vector<uint8_t> binary;
+};
+
+/*
+ * @brief  Result of one api call of ROBOT_API_ID_BATCH
+ * @class: BatchResult
+ */
+class BatchResult
+{
+public:
+    BatchResult() : code(0)
+    {}
+
+    UT_BINARY_CODEC(code, data, binary)
+
+public:
+    int32_t code;
+    std::string data;
+    std::vector<uint8_t> binary;
+};
+
+/*
+ * @brief  Input parameter type for ROBOT_API_ID_BATCH, binary encoded.
+ *         With stopOnError, calls after the first failed one are not run.
+ * @class: BatchParameter
+ */
+class BatchParameter
+{
+public:
+    BatchParameter() : stopOnError(true)
+    {}
+
+    UT_BINARY_CODEC(stopOnError, calls)
+
+public:
+    bool stopOnError;
+    std::vector<BatchCall> calls;
+};
+
+/*
+ * @brief  Output data type for ROBOT_API_ID_BATCH, binary encoded.
+ *         One result for each call run.
+ * @class: BatchData
+ */
+class BatchData
+{
+public:
+    BatchData()
+    {}
+
+    UT_BINARY_CODEC(results)
+
+public:
+    std::vector<BatchResult> results;
+};
+
+/*
+ * @brief  Operation of ROBOT_API_ID_TRANSFER.
+ *         WRITE: write chunk of parameter at offset.
+ *         QUERY: state of transfer, to resume it.
+ *         READ:  read chunk of data at offset once api has run.
+ *         CLOSE: drop transfer, sent without reply.
+ */
+const int32_t ROBOT_TRANSFER_OP_WRITE               = 0;
+const int32_t ROBOT_TRANSFER_OP_QUERY               = 1;
+const int32_t ROBOT_TRANSFER_OP_READ                = 2;
+const int32_t ROBOT_TRANSFER_OP_CLOSE               = 3;
+
+/*
+ * @brief  Input parameter type for ROBOT_API_ID_TRANSFER, binary encoded.
+ *         Parameter of apiId is size bytes sent in chunks of chunkSize,
+ *         the last one may be shorter.
+ * @class: TransferParameter
+ */
+class TransferParameter
+{
+public:
+    TransferParameter() : id(0), op(ROBOT_TRANSFER_OP_WRITE), apiId(0), chunkSize(0), size(0), offset(0)
+    {}
+
+    UT_BINARY_CODEC(id, op, apiId, chunkSize, size, offset, chunk)
+
+public:
+    int64_t id;
+    int32_t op;
+    int32_t apiId;
+    uint32_t chunkSize;
+    uint64_t size;
+    uint64_t offset;
+    std::vector<uint8_t> chunk;
+};
+
+/*
+ * @brief  Output data type for ROBOT_API_ID_TRANSFER, binary encoded.
+ *         received is bytes of parameter received without gap from start.
+ *         Once done, code is result of api and size is size of its data,
+ *         chunk is data at offset of the request, 0 for WRITE and QUERY.
+ * @class: TransferData
+ */
+class TransferData
+{
+public:
+    TransferData() : received(0), done(false), code(0), size(0)
+    {}
+
+    UT_BINARY_CODEC(received, done, code, size, chunk)
+
+public:
+    uint64_t received;
+    bool done;
+    int32_t code;
+    uint64_t size;
+    std::vector<uint8_t> chunk;
+};
 }
 }
 #endif//__UT_ROBOT_SDK_INERNAL_API_HPP__
@@ -23,6 +23,9 @@ UT_DECL_ERR(UT_ROBOT_ERR_SERVER_API_PARAMETER,      3204,   "Api parameter error
 UT_DECL_ERR(UT_ROBOT_ERR_SERVER_LEASE_DENIED,       3205,   "Request denied by lease.")
 UT_DECL_ERR(UT_ROBOT_ERR_SERVER_LEASE_NOT_EXIST,    3206,   "Lease not exist in server cache.")
 UT_DECL_ERR(UT_ROBOT_ERR_SERVER_LEASE_EXIST,        3207,   "Lease is already exist in server cache.")
+UT_DECL_ERR(UT_ROBOT_ERR_SERVER_API_EXPIRED,        3208,   "Request expired before dispatch.")
+UT_DECL_ERR(UT_ROBOT_ERR_SERVER_TRANSFER_NOT_EXIST, 3209,   "Transfer not exist in server cache.")
+UT_DECL_ERR(UT_ROBOT_ERR_SERVER_TRANSFER_LIMIT,     3210,   "Transfer exceeds server limit.")
 }
 }
 
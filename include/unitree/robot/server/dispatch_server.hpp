@@ -0,0 +1,1354 @@
+#ifndef __UT_ROBOT_SDK_DISPATCH_SERVER_HPP__
+#define __UT_ROBOT_SDK_DISPATCH_SERVER_HPP__
+
+#include <deque>
+#include <map>
+#include <unitree/robot/server/server.hpp>
+#include <unitree/robot/future/request_slot_table.hpp>
+#include <unitree/robot/internal/api_latency.hpp>
+
+/*
+ * default worker threads of DispatchServer.
+ */
+#define UT_ROBOT_SERVER_WORKER_NUMBER       4
+#define UT_ROBOT_SERVER_WORKER_WAIT_MICROSEC 1000000
+
+/*
+ * route channels kept for client transports, the least recently used one
+ * is dropped beyond it.
+ */
+#define UT_ROBOT_SERVER_ROUTE_MAX           256
+
+/*
+ * transfers kept at once, largest parameter of a transfer, bytes received
+ * and kept of all transfers, largest chunk of a transfer, chunks kept
+ * after a gap, and idle time after which a transfer not running is
+ * dropped. Memory is taken as chunks arrive, not when a transfer opens.
+ */
+#define UT_ROBOT_SERVER_TRANSFER_MAX            16
+#define UT_ROBOT_SERVER_TRANSFER_MAX_SIZE       (256 * 1024 * 1024)
+#define UT_ROBOT_SERVER_TRANSFER_MAX_TOTAL_SIZE (512 * 1024 * 1024)
+#define UT_ROBOT_SERVER_TRANSFER_MAX_CHUNK      (1024 * 1024)
+#define UT_ROBOT_SERVER_TRANSFER_MAX_PENDING    16
+#define UT_ROBOT_SERVER_TRANSFER_IDLE_MICROSEC  30000000
+
+#define UT_ROBOT_SERVER_REG_API_HANDLER_ORDER(apiId, handler, checkLease, order)        \
+    RegistHandler(apiId, std::bind(handler, this, std::placeholders::_1, std::placeholders::_2), checkLease, order)
+
+#define UT_ROBOT_SERVER_REG_API_BINARY_HANDLER_ORDER(apiId, handler, checkLease, order) \
+    RegistBinaryHandler(apiId, std::bind(handler, this, std::placeholders::_1, std::placeholders::_2), checkLease, order)
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * @struct: ServerStreamStatistics
+ *          Receiving side of a stream api. lostCount is by sequence gaps of
+ *          each client transport, overwrittenCount are setpoints replaced by
+ *          a newer one before run, staleCount are setpoints older than max
+ *          age when a worker got to them.
+ */
+struct ServerStreamStatistics
+{
+    ServerStreamStatistics() :
+        receivedCount(0), handledCount(0), lostCount(0), reorderedCount(0),
+        overwrittenCount(0), staleCount(0), lastReceiveTime(0)
+    {}
+
+    uint64_t receivedCount;
+    uint64_t handledCount;
+    uint64_t lostCount;
+    uint64_t reorderedCount;
+    uint64_t overwrittenCount;
+    uint64_t staleCount;
+    uint64_t lastReceiveTime;
+};
+
+/*
+ * @brief
+ * @struct: ServerDispatchStatistics
+ *          Queued requests of DispatchServer, of all apis or of one api.
+ *          queueDepth is requests waiting for a worker now, shedCount is
+ *          requests dropped because budget of their client ran out before
+ *          a worker got to them.
+ */
+struct ServerDispatchStatistics
+{
+    ServerDispatchStatistics() :
+        queueDepth(0), maxQueueDepth(0), dispatchedCount(0), shedCount(0)
+    {}
+
+    uint64_t queueDepth;
+    uint64_t maxQueueDepth;
+    uint64_t dispatchedCount;
+    uint64_t shedCount;
+};
+
+/*
+ * @brief  Ordering class of api in DispatchServer.
+ *         SERIALIZED: one at a time with all serialized apis, as Server.
+ *         LEASE:      one at a time per lease id of request.
+ *         CONCURRENT: any worker, no order.
+ */
+const int32_t ROBOT_API_ORDER_SERIALIZED            = 0;
+const int32_t ROBOT_API_ORDER_LEASE                 = 1;
+const int32_t ROBOT_API_ORDER_CONCURRENT            = 2;
+
+/*
+ * @brief
+ * @class: DispatchServer
+ *         Server running requests on a worker pool. Each api declares an
+ *         ordering class at registration, apis not declared stay serialized.
+ *         Internal and lease apis are run by Server on the stub thread.
+ *         With enableProiQueue, priority requests keep their ordering
+ *         class and are queued ahead of requests not yet run.
+ *         Lease is checked by the worker right before the handler runs.
+ *         ROBOT_API_ID_BATCH runs several apis in order on the serialized
+ *         strand, under one lease check.
+ *         Responses of ClientTransport requests are written to the route
+ *         channel of the transport, so clients do not read responses of
+ *         each other. Requests carrying a budget in their id are answered
+ *         with UT_ROBOT_ERR_SERVER_API_EXPIRED instead of run, if the budget
+ *         ran out while they were queued. Budget is counted from the stub
+ *         handing request to DispatchServer, time in the request queue of
+ *         ServerStub and in dds is not seen. Only CodecClient requests carry
+ *         a budget, of 10ms units up to 40.95s; requests of Client and
+ *         longer budgets have no deadline. A request carrying a valid lease
+ *         renews the lease, advertised by ROBOT_API_VERSION_RENEWAL_TAG.
+ *         Chunks of ROBOT_API_ID_TRANSFER are taken by any worker, and the
+ *         binary api runs in its own ordering class once all chunks of its
+ *         parameter arrived, advertised by ROBOT_API_VERSION_TRANSFER_TAG.
+ *         Queue wait, handler and reply times are recorded in ApiLatency.
+ */
+class DispatchServer : public Server
+{
+public:
+    explicit DispatchServer(const std::string& name) :
+        Server(name), mQuit(false), mEnableProiQueue(false), mRenewalLeaseId(0), mRenewalTime(0),
+        mLatency(ApiLatency::Instance()->Get(name)), mTransferTotalSize(0)
+    {
+        mApiOrderMap[ROBOT_API_ID_TRANSFER] = ROBOT_API_ORDER_CONCURRENT;
+    }
+
+    virtual ~DispatchServer()
+    {
+        Stop();
+    }
+
+    void Start(bool enableProiQueue = false)
+    {
+        Start(enableProiQueue, UT_ROBOT_SERVER_WORKER_NUMBER);
+    }
+
+    void Start(bool enableProiQueue, uint32_t workerNumber)
+    {
+        if (workerNumber == 0)
+        {
+            workerNumber = 1;
+        }
+
+        mEnableProiQueue = enableProiQueue;
+
+        std::string version = GetApiVersion();
+        if (version.find(ROBOT_API_VERSION_RENEWAL_TAG) == std::string::npos)
+        {
+            version += ROBOT_API_VERSION_RENEWAL_TAG;
+        }
+
+        if (version.find(ROBOT_API_VERSION_TRANSFER_TAG) == std::string::npos)
+        {
+            version += ROBOT_API_VERSION_TRANSFER_TAG;
+        }
+
+        SetApiVersion(version);
+
+        for (uint32_t i=0; i<workerNumber; i++)
+        {
+            mWorkerList.push_back(common::CreateThreadEx("srvwk", UT_CPU_ID_NONE, &DispatchServer::WorkerFunction, this));
+        }
+
+        Server::Start(enableProiQueue);
+    }
+
+    /*
+     * Id of api the calling thread is running, by a worker or by Server on
+     * the stub thread. Server::GetCurrentApiId is not virtual and only knows
+     * apis run by Server, call this one on DispatchServer.
+     */
+    int32_t GetCurrentApiId() const
+    {
+        return (mWorkerApiId != ROBOT_API_ID_NONE) ? mWorkerApiId : Server::GetCurrentApiId();
+    }
+
+    /*
+     * Queue depth, dispatched and shed requests of all apis.
+     */
+    void GetDispatchStatistics(ServerDispatchStatistics& statistics)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+        statistics = mDispatchStatistics;
+    }
+
+    /*
+     * Of one api, false if no request of api was queued yet.
+     */
+    bool GetDispatchStatistics(int32_t apiId, ServerDispatchStatistics& statistics)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        auto iter = mApiDispatchMap.find(apiId);
+        if (iter == mApiDispatchMap.end())
+        {
+            return false;
+        }
+
+        statistics = iter->second;
+        return true;
+    }
+
+protected:
+    using Server::RegistHandler;
+    using Server::RegistBinaryHandler;
+
+    void RegistHandler(int32_t apiId, const RequestHandler& handler, bool checkLease, int32_t order)
+    {
+        SetApiOrder(apiId, order);
+        Server::RegistHandler(apiId, handler, checkLease);
+    }
+
+    void RegistBinaryHandler(int32_t apiId, const BinaryRequestHandler& binaryHandler, bool checkLease, int32_t order)
+    {
+        SetApiOrder(apiId, order);
+        Server::RegistBinaryHandler(apiId, binaryHandler, checkLease);
+    }
+
+    void SetApiOrder(int32_t apiId, int32_t order)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+        mApiOrderMap[apiId] = order;
+    }
+
+    /*
+     * Regist handler of stream api, requests are sent without reply and only
+     * the newest one waiting is run. maxAge > 0 drops setpoints waited
+     * longer than maxAge microseconds.
+     */
+    void RegistStreamHandler(int32_t apiId, const RequestHandler& handler, bool checkLease = false, int64_t maxAge = 0)
+    {
+        SetStream(apiId, maxAge);
+        Server::RegistHandler(apiId, handler, checkLease);
+    }
+
+    void RegistStreamBinaryHandler(int32_t apiId, const BinaryRequestHandler& binaryHandler, bool checkLease = false, int64_t maxAge = 0)
+    {
+        SetStream(apiId, maxAge);
+        Server::RegistBinaryHandler(apiId, binaryHandler, checkLease);
+    }
+
+    bool GetStreamStatistics(int32_t apiId, ServerStreamStatistics& statistics)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        auto iter = mStreamMap.find(apiId);
+        if (iter == mStreamMap.end())
+        {
+            return false;
+        }
+
+        statistics = iter->second.mStatistics;
+        return true;
+    }
+
+    void ServerRequestHandler(const RequestPtr& request)
+    {
+        //earliest time request is seen here, budget counts from it
+        uint64_t receiveTime = common::GetCurrentMonotonicTimeMicrosecond();
+        int32_t apiId = request->header().identity().api_id();
+
+        if (apiId <= ROBOT_INTERNAL_API_ID_MAX || apiId == ROBOT_API_ID_LEASE_APPLY ||
+            apiId == ROBOT_API_ID_LEASE_RENEWAL)
+        {
+            Server::ServerRequestHandler(request);
+            return;
+        }
+
+        RenewLease(request->header().lease().id());
+
+        if (EnqueueStream(request))
+        {
+            return;
+        }
+
+        Enqueue(request, receiveTime);
+    }
+
+    void Stop()
+    {
+        {
+            common::LockGuard<common::MutexCond> guard(mMutexCond);
+            mQuit = true;
+            mMutexCond.NotifyAll();
+        }
+
+        for (common::ThreadPtr& threadPtr : mWorkerList)
+        {
+            threadPtr->Wait();
+        }
+
+        mWorkerList.clear();
+    }
+
+private:
+    struct Stream;
+
+    /*
+     * Parameter of a binary api received in chunks.
+     */
+    struct Transfer
+    {
+        enum
+        {
+            RECEIVING,
+            RUNNING,
+            DONE
+        };
+
+        Transfer() :
+            mApiId(0), mChunkSize(0), mSize(0), mChunkCount(0), mContiguousCount(0), mHeldSize(0),
+            mTagged(false), mRoute(0), mState(RECEIVING), mCode(UT_ROBOT_OK), mActiveTime(0)
+        {}
+
+        int32_t mApiId;
+        uint32_t mChunkSize;
+        uint64_t mSize;
+        uint64_t mChunkCount;
+        uint64_t mContiguousCount;
+        uint64_t mHeldSize;
+
+        //route tag of the client transport opening it
+        bool mTagged;
+        uint32_t mRoute;
+
+        int32_t mState;
+        int32_t mCode;
+        uint64_t mActiveTime;
+
+        //chunks without gap from start, and chunks after a gap by index
+        std::vector<uint8_t> mBuffer;
+        std::map<uint64_t,std::vector<uint8_t>> mPending;
+
+        //data of api once done
+        std::vector<uint8_t> mData;
+    };
+
+    using TransferPtr = std::shared_ptr<Transfer>;
+
+    struct Task
+    {
+        RequestPtr mRequest;
+        bool mOrdered;
+        int64_t mKey;
+        Stream* mStream;
+
+        //monotonic time the request expires, 0 for none
+        uint64_t mDeadline;
+        uint64_t mReceiveTime;
+
+        //api run for a completed transfer, answered by RunTransfer
+        TransferPtr mTransfer;
+
+        //priority request with enableProiQueue, queued ahead of others
+        bool mPriority;
+    };
+
+    /*
+     * Tasks in order, priority tasks ahead of the others and in order among
+     * themselves.
+     */
+    struct TaskQueue
+    {
+        TaskQueue() :
+            mPriorityCount(0)
+        {}
+
+        bool Empty() const
+        {
+            return mTasks.empty();
+        }
+
+        void Push(const Task& task)
+        {
+            if (task.mPriority)
+            {
+                mTasks.insert(mTasks.begin() + mPriorityCount, task);
+                mPriorityCount ++;
+            }
+            else
+            {
+                mTasks.push_back(task);
+            }
+        }
+
+        Task Pop()
+        {
+            Task task = mTasks.front();
+            mTasks.pop_front();
+
+            if (task.mPriority)
+            {
+                mPriorityCount --;
+            }
+
+            return task;
+        }
+
+        std::deque<Task> mTasks;
+        size_t mPriorityCount;
+    };
+
+    struct Strand
+    {
+        Strand() :
+            mActive(false)
+        {}
+
+        bool mActive;
+        TaskQueue mQueue;
+    };
+
+    struct Stream
+    {
+        Stream() :
+            mMaxAge(0), mScheduled(false), mReceiveTime(0)
+        {}
+
+        int64_t mMaxAge;
+        bool mScheduled;
+
+        RequestPtr mLatest;
+        uint64_t mReceiveTime;
+
+        //last sequence by route of client transport
+        std::unordered_map<uint32_t,uint32_t> mSequenceMap;
+        ServerStreamStatistics mStatistics;
+    };
+
+    struct Route
+    {
+        RpcChannelPtr<Response> mChannelPtr;
+        std::list<uint32_t>::iterator mListIter;
+    };
+
+    /*
+     * Renew lease of request as a ROBOT_API_ID_LEASE_RENEWAL without reply,
+     * at most once a ROBOT_LEASE_RENEWAL_INTERVAL. Called by stub threads.
+     */
+    void RenewLease(int64_t leaseId)
+    {
+        if (leaseId == 0)
+        {
+            return;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        if (leaseId == mRenewalLeaseId.load() && now < mRenewalTime.load() + ROBOT_LEASE_RENEWAL_INTERVAL)
+        {
+            return;
+        }
+
+        if (CheckLeaseDenied(leaseId))
+        {
+            return;
+        }
+
+        RequestPtr renewal(new Request());
+        renewal->header().identity().api_id(ROBOT_API_ID_LEASE_RENEWAL);
+        renewal->header().lease().id(leaseId);
+        renewal->header().policy().noreply(true);
+
+        Server::ServerRequestHandler(renewal);
+
+        mRenewalTime = now;
+        mRenewalLeaseId = leaseId;
+    }
+
+    void SetStream(int32_t apiId, int64_t maxAge)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+        mStreamMap[apiId].mMaxAge = maxAge;
+    }
+
+    bool EnqueueStream(const RequestPtr& request)
+    {
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        auto iter = mStreamMap.find(request->header().identity().api_id());
+        if (iter == mStreamMap.end())
+        {
+            return false;
+        }
+
+        Stream& stream = iter->second;
+        ServerStreamStatistics& statistics = stream.mStatistics;
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+        statistics.receivedCount ++;
+        statistics.lastReceiveTime = now;
+
+        int64_t requestId = request->header().identity().id();
+        uint32_t route = 0;
+
+        if (RequestSlotTable::GetRequestTag(requestId, route))
+        {
+            uint32_t sequence = RequestSlotTable::GetRequestSequence(requestId);
+
+            auto seqIter = stream.mSequenceMap.find(route);
+            if (seqIter != stream.mSequenceMap.end())
+            {
+                int32_t delta = RequestSlotTable::GetSequenceDelta(seqIter->second, sequence);
+                if (delta <= 0)
+                {
+                    statistics.reorderedCount ++;
+                    return true;
+                }
+
+                statistics.lostCount += delta - 1;
+                seqIter->second = sequence;
+            }
+            else
+            {
+                if (stream.mSequenceMap.size() >= UT_ROBOT_SERVER_ROUTE_MAX)
+                {
+                    stream.mSequenceMap.clear();
+                }
+
+                stream.mSequenceMap[route] = sequence;
+            }
+        }
+
+        if (stream.mLatest)
+        {
+            statistics.overwrittenCount ++;
+        }
+
+        stream.mLatest = request;
+        stream.mReceiveTime = now;
+
+        if (!stream.mScheduled)
+        {
+            stream.mScheduled = true;
+            mReadyQueue.Push(Task{RequestPtr(), false, 0, &stream, 0, 0, TransferPtr(), false});
+            mMutexCond.Notify();
+        }
+
+        return true;
+    }
+
+    void RunStream(Stream& stream)
+    {
+        RequestPtr request;
+        bool stale = false;
+
+        {
+            common::LockGuard<common::MutexCond> guard(mMutexCond);
+            request.swap(stream.mLatest);
+
+            if (request)
+            {
+                mLatency->RecordSince(request->header().identity().api_id(), ROBOT_API_LATENCY_SERVER_QUEUE,
+                    stream.mReceiveTime);
+            }
+
+            if (stream.mMaxAge > 0 && common::GetCurrentMonotonicTimeMicrosecond() > stream.mReceiveTime + stream.mMaxAge)
+            {
+                stale = true;
+            }
+        }
+
+        if (request && !stale)
+        {
+            Dispatch(request);
+        }
+
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        if (stale)
+        {
+            stream.mStatistics.staleCount ++;
+        }
+        else if (request)
+        {
+            stream.mStatistics.handledCount ++;
+        }
+
+        if (stream.mLatest)
+        {
+            mReadyQueue.Push(Task{RequestPtr(), false, 0, &stream, 0, 0, TransferPtr(), false});
+            mMutexCond.Notify();
+        }
+        else
+        {
+            stream.mScheduled = false;
+        }
+    }
+
+    void Enqueue(const RequestPtr& request, uint64_t now, const TransferPtr& transferPtr = TransferPtr())
+    {
+        uint64_t deadline = 0;
+
+        int64_t budget = RequestSlotTable::GetRequestBudget(request->header().identity().id());
+        if (budget > 0)
+        {
+            /*
+             * clocks of client and server hosts are not comparable, deadline
+             * is counted from receiving, as ThreadPool counts overdue of task
+             * from enqueue.
+             */
+            deadline = now + budget;
+        }
+
+        common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+        AddQueueDepth(mDispatchStatistics);
+        AddQueueDepth(mApiDispatchMap[request->header().identity().api_id()]);
+
+        /*
+         * priority requests run in the strand of their api too, ahead of
+         * requests waiting in it and in the ready queue.
+         */
+        bool priority = mEnableProiQueue && request->header().policy().priority() > 0;
+        int32_t order = ROBOT_API_ORDER_SERIALIZED;
+
+        auto iter = mApiOrderMap.find(request->header().identity().api_id());
+        if (iter != mApiOrderMap.end())
+        {
+            order = iter->second;
+        }
+
+        if (order == ROBOT_API_ORDER_CONCURRENT)
+        {
+            mReadyQueue.Push(Task{request, false, 0, NULL, deadline, now, transferPtr, priority});
+        }
+        else
+        {
+            /*
+             * serialized apis share one strand, other strands are by lease id.
+             */
+            int64_t key = (order == ROBOT_API_ORDER_LEASE) ? request->header().lease().id() : INT64_MIN;
+
+            Strand& strand = mStrandMap[key];
+            if (strand.mActive)
+            {
+                strand.mQueue.Push(Task{request, true, key, NULL, deadline, now, transferPtr, priority});
+                return;
+            }
+
+            strand.mActive = true;
+            mReadyQueue.Push(Task{request, true, key, NULL, deadline, now, transferPtr, priority});
+        }
+
+        mMutexCond.Notify();
+    }
+
+    int32_t WorkerFunction()
+    {
+        while (true)
+        {
+            Task task;
+            bool expired = false;
+
+            {
+                common::LockGuard<common::MutexCond> guard(mMutexCond);
+                while (mReadyQueue.Empty() && !mQuit)
+                {
+                    mMutexCond.Wait(UT_ROBOT_SERVER_WORKER_WAIT_MICROSEC);
+                }
+
+                if (mQuit)
+                {
+                    break;
+                }
+
+                task = mReadyQueue.Pop();
+
+                if (task.mStream == NULL)
+                {
+                    expired = IsTaskOverdue(task);
+
+                    CountDequeue(mDispatchStatistics, expired);
+                    CountDequeue(mApiDispatchMap[task.mRequest->header().identity().api_id()], expired);
+                }
+            }
+
+            if (task.mStream != NULL)
+            {
+                RunStream(*task.mStream);
+                continue;
+            }
+
+            mLatency->RecordSince(task.mRequest->header().identity().api_id(), ROBOT_API_LATENCY_SERVER_QUEUE,
+                task.mReceiveTime);
+
+            if (task.mTransfer)
+            {
+                RunTransfer(task, expired);
+            }
+            else if (expired)
+            {
+                Shed(task.mRequest);
+            }
+            else
+            {
+                Dispatch(task.mRequest);
+            }
+
+            if (task.mOrdered)
+            {
+                common::LockGuard<common::MutexCond> guard(mMutexCond);
+
+                auto iter = mStrandMap.find(task.mKey);
+                Strand& strand = iter->second;
+
+                if (strand.mQueue.Empty())
+                {
+                    mStrandMap.erase(iter);
+                }
+                else
+                {
+                    mReadyQueue.Push(strand.mQueue.Pop());
+                    mMutexCond.Notify();
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    static void AddQueueDepth(ServerDispatchStatistics& statistics)
+    {
+        statistics.queueDepth ++;
+        if (statistics.queueDepth > statistics.maxQueueDepth)
+        {
+            statistics.maxQueueDepth = statistics.queueDepth;
+        }
+    }
+
+    static void CountDequeue(ServerDispatchStatistics& statistics, bool shed)
+    {
+        statistics.queueDepth --;
+
+        if (shed)
+        {
+            statistics.shedCount ++;
+        }
+        else
+        {
+            statistics.dispatchedCount ++;
+        }
+    }
+
+    bool IsTaskOverdue(const Task& task)
+    {
+        return task.mDeadline > 0 && common::GetCurrentMonotonicTimeMicrosecond() > task.mDeadline;
+    }
+
+    /*
+     * Answer request dropped before dispatch, its client may still wait if
+     * budget was shorter than its timeout.
+     */
+    void Shed(const RequestPtr& request)
+    {
+        const RequestHeader& header = request->header();
+        if (header.policy().noreply())
+        {
+            return;
+        }
+
+        Response response;
+        response.header().identity().id(header.identity().id());
+        response.header().identity().api_id(header.identity().api_id());
+        response.header().status().code(UT_ROBOT_ERR_SERVER_API_EXPIRED);
+
+        Reply(response);
+    }
+
+    void Dispatch(const RequestPtr& request)
+    {
+        const RequestHeader& header = request->header();
+        int32_t apiId = header.identity().api_id();
+
+        Response response;
+        response.header().identity().id(header.identity().id());
+        response.header().identity().api_id(apiId);
+
+        int32_t code = UT_ROBOT_OK;
+        uint64_t startTime = common::GetCurrentMonotonicTimeMicrosecond();
+
+        if (apiId == ROBOT_API_ID_BATCH)
+        {
+            code = DispatchBatch(*request, response.binary());
+        }
+        else if (apiId == ROBOT_API_ID_TRANSFER)
+        {
+            if (!DispatchTransfer(request, code, response.binary()))
+            {
+                return;
+            }
+        }
+        else
+        {
+            code = Handle(apiId, header.lease().id(), false, request->parameter(), request->binary(),
+                response.data(), response.binary());
+        }
+
+        uint64_t handledTime = mLatency->RecordSince(apiId, ROBOT_API_LATENCY_SERVER_HANDLER, startTime);
+
+        if (header.policy().noreply())
+        {
+            return;
+        }
+
+        response.header().status().code(code);
+        Reply(response);
+
+        mLatency->RecordSince(apiId, ROBOT_API_LATENCY_SERVER_REPLY, handledTime);
+    }
+
+    /*
+     * Run handler of api, lease is not checked again if leaseChecked.
+     */
+    int32_t Handle(int32_t apiId, int64_t leaseId, bool leaseChecked, const std::string& parameter,
+        const std::vector<uint8_t>& binary, std::string& data, std::vector<uint8_t>& binData)
+    {
+        int32_t code = UT_ROBOT_OK;
+        bool ignoreLease = false;
+
+        mWorkerApiId = apiId;
+
+        try
+        {
+            if (IsBinary(apiId))
+            {
+                BinaryRequestHandler handler = GetBinaryHandler(apiId, ignoreLease);
+                code = CheckHandler((bool)handler, ignoreLease || leaseChecked, leaseId);
+                if (code == UT_ROBOT_OK)
+                {
+                    code = handler(binary, binData);
+                }
+            }
+            else
+            {
+                RequestHandler handler = GetHandler(apiId, ignoreLease);
+                code = CheckHandler((bool)handler, ignoreLease || leaseChecked, leaseId);
+                if (code == UT_ROBOT_OK)
+                {
+                    code = handler(parameter, data);
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            code = UT_ROBOT_ERR_SERVER_INTERNAL;
+        }
+
+        mWorkerApiId = ROBOT_API_ID_NONE;
+
+        return code;
+    }
+
+    /*
+     * Run calls of batch in order. Lease is checked once for the batch if
+     * any of its apis checks lease.
+     */
+    int32_t DispatchBatch(const Request& request, std::vector<uint8_t>& binData)
+    {
+        BatchParameter parameter;
+        if (!common::DecodeBinary(request.binary(), parameter))
+        {
+            return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+        }
+
+        int64_t leaseId = request.header().lease().id();
+        bool checkLease = false;
+
+        for (const BatchCall& call : parameter.calls)
+        {
+            if (call.apiId <= ROBOT_INTERNAL_API_ID_MAX || call.apiId == ROBOT_API_ID_LEASE_APPLY ||
+                call.apiId == ROBOT_API_ID_LEASE_RENEWAL || call.apiId == ROBOT_API_ID_BATCH)
+            {
+                return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            }
+
+            bool ignoreLease = false;
+            bool exist = IsBinary(call.apiId) ? (bool)GetBinaryHandler(call.apiId, ignoreLease) :
+                (bool)GetHandler(call.apiId, ignoreLease);
+
+            if (exist && !ignoreLease)
+            {
+                checkLease = true;
+            }
+        }
+
+        if (checkLease && CheckLeaseDenied(leaseId))
+        {
+            return UT_ROBOT_ERR_SERVER_LEASE_DENIED;
+        }
+
+        BatchData data;
+        data.results.reserve(parameter.calls.size());
+
+        for (const BatchCall& call : parameter.calls)
+        {
+            data.results.emplace_back();
+
+            BatchResult& result = data.results.back();
+            result.code = Handle(call.apiId, leaseId, true, call.parameter, call.binary, result.data, result.binary);
+
+            if (result.code != UT_ROBOT_OK && parameter.stopOnError)
+            {
+                break;
+            }
+        }
+
+        common::EncodeBinary(data, binData);
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * Run a chunk of ROBOT_API_ID_TRANSFER. The chunk completing parameter
+     * queues the api as a request of its own ordering class and is answered
+     * by RunTransfer, return false then.
+     */
+    bool DispatchTransfer(const RequestPtr& request, int32_t& code, std::vector<uint8_t>& binData)
+    {
+        TransferParameter parameter;
+        if (!common::DecodeBinary(request->binary(), parameter))
+        {
+            code = UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            return true;
+        }
+
+        uint64_t now = common::GetCurrentMonotonicTimeMicrosecond();
+
+        TransferPtr transferPtr;
+        RequestPtr apiRequest;
+        TransferData data;
+
+        {
+            common::LockGuard<common::Mutex> guard(mTransferMutex);
+
+            DropIdleTransfer(now);
+
+            auto iter = mTransferMap.find(parameter.id);
+            if (iter != mTransferMap.end())
+            {
+                transferPtr = iter->second;
+            }
+
+            /*
+             * a transfer is only seen by the client transport opening it.
+             */
+            uint32_t route = 0;
+            bool tagged = RequestSlotTable::GetRequestTag(request->header().identity().id(), route);
+
+            if (transferPtr && (transferPtr->mTagged != tagged || transferPtr->mRoute != route))
+            {
+                code = UT_ROBOT_ERR_SERVER_TRANSFER_NOT_EXIST;
+                return true;
+            }
+
+            if (parameter.op == ROBOT_TRANSFER_OP_CLOSE)
+            {
+                if (transferPtr && transferPtr->mState != Transfer::RUNNING)
+                {
+                    EraseTransfer(iter);
+                }
+
+                code = UT_ROBOT_OK;
+                return true;
+            }
+
+            if (!transferPtr)
+            {
+                code = (parameter.op == ROBOT_TRANSFER_OP_WRITE) ?
+                    CreateTransfer(parameter, request->header().lease().id(), tagged, route, transferPtr) :
+                    UT_ROBOT_ERR_SERVER_TRANSFER_NOT_EXIST;
+
+                if (code != UT_ROBOT_OK)
+                {
+                    return true;
+                }
+            }
+
+            Transfer& transfer = *transferPtr;
+            transfer.mActiveTime = now;
+
+            if (parameter.op == ROBOT_TRANSFER_OP_WRITE)
+            {
+                code = WriteTransfer(transfer, parameter);
+                if (code != UT_ROBOT_OK)
+                {
+                    return true;
+                }
+
+                if (transfer.mState == Transfer::RECEIVING && transfer.mContiguousCount == transfer.mChunkCount)
+                {
+                    transfer.mState = Transfer::RUNNING;
+
+                    apiRequest.reset(new Request());
+                    apiRequest->header() = request->header();
+                    apiRequest->header().identity().api_id(transfer.mApiId);
+                    apiRequest->binary().swap(transfer.mBuffer);
+                }
+            }
+            else if (parameter.op == ROBOT_TRANSFER_OP_READ)
+            {
+                if (transfer.mState != Transfer::DONE || parameter.offset > transfer.mData.size())
+                {
+                    code = UT_ROBOT_ERR_SERVER_API_PARAMETER;
+                    return true;
+                }
+            }
+            else if (parameter.op != ROBOT_TRANSFER_OP_QUERY)
+            {
+                code = UT_ROBOT_ERR_SERVER_API_PARAMETER;
+                return true;
+            }
+
+            GetTransferData(transfer, (parameter.op == ROBOT_TRANSFER_OP_READ) ? parameter.offset : 0, data);
+        }
+
+        if (apiRequest)
+        {
+            Enqueue(apiRequest, common::GetCurrentMonotonicTimeMicrosecond(), transferPtr);
+            return false;
+        }
+
+        common::EncodeBinary(data, binData);
+        code = UT_ROBOT_OK;
+
+        return true;
+    }
+
+    /*
+     * Run api of a completed transfer, answering its last chunk.
+     */
+    void RunTransfer(const Task& task, bool expired)
+    {
+        const RequestHeader& header = task.mRequest->header();
+        int32_t apiId = header.identity().api_id();
+
+        int32_t code = UT_ROBOT_ERR_SERVER_API_EXPIRED;
+        std::string data;
+        std::vector<uint8_t> binData;
+
+        if (!expired)
+        {
+            uint64_t startTime = common::GetCurrentMonotonicTimeMicrosecond();
+            code = Handle(apiId, header.lease().id(), false, task.mRequest->parameter(), task.mRequest->binary(),
+                data, binData);
+            mLatency->RecordSince(apiId, ROBOT_API_LATENCY_SERVER_HANDLER, startTime);
+        }
+
+        TransferData transferData;
+
+        {
+            common::LockGuard<common::Mutex> guard(mTransferMutex);
+
+            Transfer& transfer = *task.mTransfer;
+            transfer.mState = Transfer::DONE;
+            transfer.mCode = code;
+            transfer.mData.swap(binData);
+            transfer.mActiveTime = common::GetCurrentMonotonicTimeMicrosecond();
+
+            GetTransferData(transfer, 0, transferData);
+        }
+
+        if (header.policy().noreply())
+        {
+            return;
+        }
+
+        Response response;
+        response.header().identity().id(header.identity().id());
+        response.header().identity().api_id(ROBOT_API_ID_TRANSFER);
+        response.header().status().code(UT_ROBOT_OK);
+        common::EncodeBinary(transferData, response.binary());
+
+        Reply(response);
+    }
+
+    /*
+     * Open transfer for the client transport of route. Lease of request is
+     * checked if the api checks lease, no memory is taken yet.
+     */
+    int32_t CreateTransfer(const TransferParameter& parameter, int64_t leaseId, bool tagged, uint32_t route,
+        TransferPtr& transferPtr)
+    {
+        int32_t apiId = parameter.apiId;
+        if (apiId <= ROBOT_INTERNAL_API_ID_MAX || apiId == ROBOT_API_ID_LEASE_APPLY || apiId == ROBOT_API_ID_LEASE_RENEWAL ||
+            apiId == ROBOT_API_ID_BATCH || apiId == ROBOT_API_ID_TRANSFER || parameter.size == 0 || parameter.chunkSize == 0)
+        {
+            return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+        }
+
+        bool ignoreLease = false;
+        if (!IsBinary(apiId) || !GetBinaryHandler(apiId, ignoreLease))
+        {
+            return UT_ROBOT_ERR_SERVER_API_NOT_IMPL;
+        }
+
+        if (!ignoreLease && CheckLeaseDenied(leaseId))
+        {
+            return UT_ROBOT_ERR_SERVER_LEASE_DENIED;
+        }
+
+        if (parameter.size > UT_ROBOT_SERVER_TRANSFER_MAX_SIZE || parameter.chunkSize > UT_ROBOT_SERVER_TRANSFER_MAX_CHUNK ||
+            mTransferMap.size() >= UT_ROBOT_SERVER_TRANSFER_MAX)
+        {
+            return UT_ROBOT_ERR_SERVER_TRANSFER_LIMIT;
+        }
+
+        transferPtr.reset(new Transfer());
+
+        Transfer& transfer = *transferPtr;
+        transfer.mApiId = apiId;
+        transfer.mChunkSize = parameter.chunkSize;
+        transfer.mSize = parameter.size;
+        transfer.mChunkCount = (parameter.size + parameter.chunkSize - 1) / parameter.chunkSize;
+        transfer.mTagged = tagged;
+        transfer.mRoute = route;
+
+        mTransferMap[parameter.id] = transferPtr;
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * Append chunk to parameter, or keep it until the gap before it is
+     * filled. Chunks arrived again, and chunks too far ahead of the gap,
+     * are ignored, the client sends them again from bytes received.
+     */
+    int32_t WriteTransfer(Transfer& transfer, const TransferParameter& parameter)
+    {
+        if (parameter.apiId != transfer.mApiId || parameter.size != transfer.mSize ||
+            parameter.chunkSize != transfer.mChunkSize)
+        {
+            return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+        }
+
+        if (transfer.mState != Transfer::RECEIVING)
+        {
+            return UT_ROBOT_OK;
+        }
+
+        if (parameter.offset >= transfer.mSize || parameter.offset % transfer.mChunkSize != 0 ||
+            parameter.chunk.size() != std::min<uint64_t>(transfer.mChunkSize, transfer.mSize - parameter.offset))
+        {
+            return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+        }
+
+        uint64_t index = parameter.offset / transfer.mChunkSize;
+        if (index < transfer.mContiguousCount || index >= transfer.mContiguousCount + UT_ROBOT_SERVER_TRANSFER_MAX_PENDING ||
+            transfer.mPending.find(index) != transfer.mPending.end())
+        {
+            return UT_ROBOT_OK;
+        }
+
+        if (mTransferTotalSize + parameter.chunk.size() > UT_ROBOT_SERVER_TRANSFER_MAX_TOTAL_SIZE)
+        {
+            return UT_ROBOT_ERR_SERVER_TRANSFER_LIMIT;
+        }
+
+        transfer.mHeldSize += parameter.chunk.size();
+        mTransferTotalSize += parameter.chunk.size();
+
+        if (index > transfer.mContiguousCount)
+        {
+            transfer.mPending[index] = parameter.chunk;
+            return UT_ROBOT_OK;
+        }
+
+        transfer.mBuffer.insert(transfer.mBuffer.end(), parameter.chunk.begin(), parameter.chunk.end());
+        transfer.mContiguousCount ++;
+
+        auto iter = transfer.mPending.begin();
+        while (iter != transfer.mPending.end() && iter->first == transfer.mContiguousCount)
+        {
+            transfer.mBuffer.insert(transfer.mBuffer.end(), iter->second.begin(), iter->second.end());
+            transfer.mContiguousCount ++;
+            iter = transfer.mPending.erase(iter);
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * State of transfer, with chunk of data at offset once done.
+     */
+    void GetTransferData(const Transfer& transfer, uint64_t offset, TransferData& data)
+    {
+        data.received = std::min<uint64_t>(transfer.mContiguousCount * transfer.mChunkSize, transfer.mSize);
+        data.done = (transfer.mState == Transfer::DONE);
+
+        if (!data.done)
+        {
+            return;
+        }
+
+        data.code = transfer.mCode;
+        data.size = transfer.mData.size();
+
+        if (offset < data.size)
+        {
+            uint64_t len = std::min<uint64_t>(transfer.mChunkSize, data.size - offset);
+            data.chunk.assign(transfer.mData.begin() + offset, transfer.mData.begin() + offset + len);
+        }
+    }
+
+    /*
+     * Drop transfers given up by their clients, running ones are kept.
+     */
+    void DropIdleTransfer(uint64_t now)
+    {
+        auto iter = mTransferMap.begin();
+        while (iter != mTransferMap.end())
+        {
+            const Transfer& transfer = *iter->second;
+            if (transfer.mState != Transfer::RUNNING && now > transfer.mActiveTime + UT_ROBOT_SERVER_TRANSFER_IDLE_MICROSEC)
+            {
+                iter = EraseTransfer(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    /*
+     * Bytes held by transfer count against the total until it is dropped,
+     * also when its buffer has moved into the running api.
+     */
+    std::unordered_map<int64_t,TransferPtr>::iterator EraseTransfer(std::unordered_map<int64_t,TransferPtr>::iterator iter)
+    {
+        mTransferTotalSize -= iter->second->mHeldSize;
+        return mTransferMap.erase(iter);
+    }
+
+    void Reply(const Response& response)
+    {
+        uint32_t route = 0;
+        if (RequestSlotTable::GetRequestTag(response.header().identity().id(), route))
+        {
+            /*
+             * a new route is not waited for, responses go to the shared
+             * channel until it matches its client.
+             */
+            RpcChannelPtr<Response> channelPtr = GetRouteChannel(route);
+            if (channelPtr->GetMatchedCount() > 0 && channelPtr->Write(response, 0))
+            {
+                return;
+            }
+        }
+
+        SendResponse(response);
+    }
+
+    RpcChannelPtr<Response> GetRouteChannel(uint32_t route)
+    {
+        {
+            common::LockGuard<common::Mutex> guard(mRouteMutex);
+
+            auto iter = mRouteChannelMap.find(route);
+            if (iter != mRouteChannelMap.end())
+            {
+                mRouteList.splice(mRouteList.begin(), mRouteList, iter->second.mListIter);
+                return iter->second.mChannelPtr;
+            }
+        }
+
+        RpcChannelPtr<Response> channelPtr = ChannelFactory::Instance()->CreateRpcSendChannel<Response>(GetRouteChannelName(GetName(), route));
+
+        common::LockGuard<common::Mutex> guard(mRouteMutex);
+
+        auto iter = mRouteChannelMap.find(route);
+        if (iter != mRouteChannelMap.end())
+        {
+            //created by another worker meanwhile
+            return iter->second.mChannelPtr;
+        }
+
+        /*
+         * routes of gone clients age out, a live one dropped is created
+         * again on its next request.
+         */
+        if (mRouteChannelMap.size() >= UT_ROBOT_SERVER_ROUTE_MAX)
+        {
+            mRouteChannelMap.erase(mRouteList.back());
+            mRouteList.pop_back();
+        }
+
+        mRouteList.push_front(route);
+
+        Route& entry = mRouteChannelMap[route];
+        entry.mChannelPtr = channelPtr;
+        entry.mListIter = mRouteList.begin();
+
+        return channelPtr;
+    }
+
+    int32_t CheckHandler(bool exist, bool ignoreLease, int64_t leaseId)
+    {
+        if (!exist)
+        {
+            return UT_ROBOT_ERR_SERVER_API_NOT_IMPL;
+        }
+
+        if (!ignoreLease && CheckLeaseDenied(leaseId))
+        {
+            return UT_ROBOT_ERR_SERVER_LEASE_DENIED;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+private:
+    bool mQuit;
+    bool mEnableProiQueue;
+
+    std::atomic<int64_t> mRenewalLeaseId;
+    std::atomic<uint64_t> mRenewalTime;
+
+    ServiceLatency* mLatency;
+
+    common::MutexCond mMutexCond;
+    std::unordered_map<int32_t,int32_t> mApiOrderMap;
+    std::unordered_map<int64_t,Strand> mStrandMap;
+    std::unordered_map<int32_t,Stream> mStreamMap;
+    TaskQueue mReadyQueue;
+    ServerDispatchStatistics mDispatchStatistics;
+    std::unordered_map<int32_t,ServerDispatchStatistics> mApiDispatchMap;
+    std::vector<common::ThreadPtr> mWorkerList;
+
+    common::Mutex mRouteMutex;
+    std::list<uint32_t> mRouteList;
+    std::unordered_map<uint32_t,Route> mRouteChannelMap;
+
+    common::Mutex mTransferMutex;
+    std::unordered_map<int64_t,TransferPtr> mTransferMap;
+    uint64_t mTransferTotalSize;
+
+    //api run by worker, Server::mCurrentApiId is private to Server
+    inline static thread_local int32_t mWorkerApiId = ROBOT_API_ID_NONE;
+};
+
+using DispatchServerPtr = std::shared_ptr<DispatchServer>;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_DISPATCH_SERVER_HPP__
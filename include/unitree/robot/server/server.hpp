@@ -3,6 +3,7 @@
 
 #include <unitree/robot/server/server_base.hpp>
 #include <unitree/robot/server/lease_server.hpp>
+#include <unitree/common/codec/binary_codec.hpp>
 
 #define UT_ROBOT_SERVER_REG_API_HANDLER_NO_LEASE(apiId, handler)            \
     UT_ROBOT_SERVER_REG_API_HANDLER(apiId, handler, false)
@@ -16,6 +17,9 @@
 #define UT_ROBOT_SERVER_REG_API_BINARY_HANDLER(apiId, handler, checkLease)  \
     RegistBinaryHandler(apiId, std::bind(handler, this, std::placeholders::_1, std::placeholders::_2), checkLease)
 
+#define UT_ROBOT_SERVER_REG_API_CODEC_HANDLER(apiId, PARAM, DATA, handler, checkLease)  \
+    RegistCodecHandler<PARAM,DATA>(apiId, std::bind(handler, this, std::placeholders::_1, std::placeholders::_2), checkLease)
+
 namespace unitree
 {
 namespace robot
@@ -47,6 +51,98 @@ protected:
     void RegistHandler(int32_t apiId, const RequestHandler& handler, bool checkLease = false);
     void RegistBinaryHandler(int32_t apiId, const BinaryRequestHandler& binaryHandler, bool checkLease = false);
 
+    /*
+     * Regist handler of typed parameter and data, reachable by json as apiId
+     * and by binary codec as ROBOT_API_BINARY_ID(apiId). Binary codec is
+     * advertised by suffix of api version, call it after SetApiVersion.
+     */
+    template<typename PARAM, typename DATA>
+    void RegistCodecHandler(int32_t apiId, const std::function<int32_t(const PARAM&, DATA&)>& handler, bool checkLease = false)
+    {
+        RegistHandler(apiId, [handler](const std::string& parameter, std::string& data) {
+            PARAM param;
+            DATA result;
+
+            try
+            {
+                common::FromJsonString(parameter, param);
+            }
+            catch (const common::Exception&)
+            {
+                return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            }
+
+            int32_t ret = handler(param, result);
+            if (ret == UT_ROBOT_OK)
+            {
+                data = common::ToJsonString(result);
+            }
+
+            return ret;
+        }, checkLease);
+
+        RegistBinaryHandler(ROBOT_API_BINARY_ID(apiId), [handler](const std::vector<uint8_t>& parameter, std::vector<uint8_t>& data) {
+            PARAM param;
+            DATA result;
+
+            if (!common::DecodeBinary(parameter, param))
+            {
+                return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            }
+
+            int32_t ret = handler(param, result);
+            if (ret == UT_ROBOT_OK)
+            {
+                common::EncodeBinary(result, data);
+            }
+
+            return ret;
+        }, checkLease);
+
+        AdvertiseBinaryCodec();
+    }
+
+    template<typename PARAM>
+    void RegistCodecHandler(int32_t apiId, const std::function<int32_t(const PARAM&)>& handler, bool checkLease = false)
+    {
+        RegistHandler(apiId, [handler](const std::string& parameter, std::string&) {
+            PARAM param;
+
+            try
+            {
+                common::FromJsonString(parameter, param);
+            }
+            catch (const common::Exception&)
+            {
+                return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            }
+
+            return handler(param);
+        }, checkLease);
+
+        RegistBinaryHandler(ROBOT_API_BINARY_ID(apiId), [handler](const std::vector<uint8_t>& parameter, std::vector<uint8_t>&) {
+            PARAM param;
+
+            if (!common::DecodeBinary(parameter, param))
+            {
+                return UT_ROBOT_ERR_SERVER_API_PARAMETER;
+            }
+
+            return handler(param);
+        }, checkLease);
+
+        AdvertiseBinaryCodec();
+    }
+
+    void AdvertiseBinaryCodec()
+    {
+        const std::string& version = GetApiVersion();
+        if (version.find(ROBOT_API_VERSION_BINARY_TAG) == std::string::npos)
+        {
+            SetApiVersion(version + ROBOT_API_VERSION_BINARY_TAG);
+        }
+    }
+
     bool IsBinary(int32_t apiId);
 
     RequestHandler GetHandler(int32_t apiId, bool& ignoreLease) const;